@@ -4,10 +4,24 @@
 #include "row_serializer.hpp"
 #include "table_function.hpp"
 
+#include "duckdb/common/exception.hpp"
 #include "duckdb/common/open_file_info.hpp"
+#include "duckdb/common/types/selection_vector.hpp"
 #include "duckdb/common/vector_size.hpp"
+#include "duckdb/execution/physical_operator.hpp"
 #include "duckdb/logging/logger.hpp"
-
+#include "duckdb/parallel/pipeline.hpp"
+#include "duckdb/planner/expression/bound_conjunction_expression.hpp"
+#include "duckdb/planner/expression/bound_reference_expression.hpp"
+#include "duckdb/planner/filter/conjunction_filter.hpp"
+#include "duckdb/planner/filter/constant_filter.hpp"
+#include "duckdb/planner/filter/dynamic_filter.hpp"
+#include "duckdb/planner/filter/in_filter.hpp"
+#include "duckdb/planner/filter/optional_filter.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <mutex>
 #include <optional>
 #include <utility>
 
@@ -15,57 +29,579 @@ namespace intellekt::duckpst {
 using namespace duckdb;
 using namespace pstsdk;
 
+// PSTFilePartitionQueues
+idx_t PSTFilePartitionQueues::file(const string &path) {
+  auto [it, inserted] = file_index.emplace(path, files.size());
+  if (inserted) {
+    files.emplace_back();
+    unplanned.push_back(0);
+  }
+
+  return it->second;
+}
+
+void PSTFilePartitionQueues::push(PSTInputPartition &&part) {
+  files[file(part.file.path)].push_back(std::move(part));
+}
+
+// PSTPartitionScan
+static constexpr uint64_t pack_range(uint64_t begin, uint64_t end) {
+  return (begin << 32) | end;
+}
+
+static constexpr std::pair<idx_t, idx_t> unpack_range(uint64_t range) {
+  return {range >> 32, range & 0xFFFFFFFF};
+}
+
+PSTPartitionScan::PSTPartitionScan(const PSTInputPartition &partition,
+                                   idx_t sequence, idx_t offset)
+    : PSTInputPartition(partition), range(pack_range(0, nodes.size())),
+      sequence(sequence), offset(offset) {}
+
+std::optional<node_id> PSTPartitionScan::claim() {
+  auto packed = range.load();
+  while (true) {
+    auto [begin, end] = unpack_range(packed);
+    if (begin >= end)
+      return {};
+
+    if (range.compare_exchange_weak(packed, pack_range(begin + 1, end)))
+      return nodes[begin];
+  }
+}
+
+vector<node_id>
+PSTPartitionScan::steal(const std::optional<std::pair<idx_t, idx_t>> &after,
+                        idx_t &position) {
+  auto packed = range.load();
+  while (true) {
+    auto [begin, end] = unpack_range(packed);
+    if (begin >= end)
+      return {};
+
+    auto middle = begin + (end - begin) / 2;
+    if (after && std::make_pair(sequence, offset + middle) <= *after)
+      return {};
+
+    if (range.compare_exchange_weak(packed, pack_range(begin, middle))) {
+      position = offset + middle;
+      return vector<node_id>(nodes.begin() + middle, nodes.begin() + end);
+    }
+  }
+}
+
+std::pair<idx_t, idx_t> PSTPartitionScan::unread() const {
+  return unpack_range(range.load());
+}
+
+idx_t PSTPartitionScan::remaining() const {
+  auto [begin, end] = unread();
+  return end - std::min(begin, end);
+}
+
+void PSTPartitionScan::close() { range = 0; }
+
 // PSTReadGlobalState
+
+// Can every projected column of a message class be read from contents tables?
+template <pst::MessageClass V>
+static bool contents_table_columns(const vector<ColumnIndex> &column_indexes) {
+  return row_serializer::plan_columns<pst::TypedBag<V>>(column_indexes)
+      .contents_table;
+}
+
+static bool reads_contents_tables(const PSTReadTableFunctionData &bind_data,
+                                  const vector<ColumnIndex> &column_indexes) {
+  auto scan_mode = bind_data.scan_mode();
+  if (bind_data.mode == PSTReadFunctionMode::Folder ||
+      scan_mode == PSTScanMode::Node)
+    return false;
+
+  if (scan_mode == PSTScanMode::ContentsTable)
+    return true;
+
+  switch (bind_data.mode) {
+  case PSTReadFunctionMode::Contact:
+    return contents_table_columns<pst::MessageClass::Contact>(column_indexes);
+  case PSTReadFunctionMode::Appointment:
+    return contents_table_columns<pst::MessageClass::Appointment>(
+        column_indexes);
+  case PSTReadFunctionMode::Task:
+    return contents_table_columns<pst::MessageClass::Task>(column_indexes);
+  case PSTReadFunctionMode::StickyNote:
+    return contents_table_columns<pst::MessageClass::StickyNote>(
+        column_indexes);
+  case PSTReadFunctionMode::DistList:
+    return contents_table_columns<pst::MessageClass::DistList>(column_indexes);
+  default:
+    return contents_table_columns<pst::MessageClass::Note>(column_indexes);
+  }
+}
+
 PSTReadGlobalState::PSTReadGlobalState(
-    const PSTReadTableFunctionData &bind_data, vector<column_t> column_ids)
-    : bind_data(bind_data), column_ids(std::move(column_ids)) {
-  auto sync_partitions = partitions.synchronize();
+    ClientContext &ctx, const PSTReadTableFunctionData &bind_data,
+    vector<column_t> column_ids, vector<ColumnIndex> column_indexes,
+    optional_ptr<TableFilterSet> table_filters)
+    : ctx(ctx), bind_data(bind_data), column_ids(std::move(column_ids)),
+      column_indexes(std::move(column_indexes)), table_filters(table_filters) {
+  contents_scan = reads_contents_tables(bind_data, this->column_indexes);
+
+  // Inputs are planned by the planners below, unless partition stats were
+  // asked for (which plans them all up front). Queues in glob order, with the
+  // files not planned yet to come.
+  auto planned_inputs = bind_data.planned_inputs();
+  for (idx_t i = 0; i < bind_data.inputs.size(); ++i) {
+    auto file = partitions.file(bind_data.inputs[i].file.path);
+    if (i >= planned_inputs)
+      ++partitions.unplanned[file];
+  }
+
   for (auto &part : bind_data.partitions.get()) {
-    sync_partitions->push(part);
+    partitions.total_rows = part.stats.row_start + part.stats.count;
+    partitions.push(PSTInputPartition(part));
   }
 
+  partitions.partition_count = bind_data.partitions->size();
   nodes_processed = 0;
+
+  // Room for the partitions of the files left to plan, as far as we can
+  // tell from the estimate
+  auto estimated_rows = bind_data.estimated_rows();
+  auto unplanned_rows =
+      estimated_rows - std::min(estimated_rows, partitions.total_rows);
+  max_threads = partitions.partition_count +
+                (unplanned_rows + bind_data.partition_size() - 1) /
+                    bind_data.partition_size();
+
+  // Stolen tails start anywhere in a partition (NIDs are 32 bits, so there
+  // are no more positions than that)
+  offset_bits = 0;
+  while (offset_bits < 32 &&
+         (idx_t(1) << offset_bits) < bind_data.partition_size())
+    ++offset_bits;
+
+  max_open_files = DEFAULT_MAX_OPEN_FILES;
+  Value setting;
+  if (ctx.TryGetCurrentSetting("pst_max_open_files", setting) &&
+      !setting.IsNull())
+    max_open_files = std::max<idx_t>(setting.GetValue<idx_t>(), 1);
+  planner_signal = std::make_shared<PSTPlannerSignal>();
+
+  next_input = planned_inputs;
+  auto workers =
+      planning_workers(ctx, bind_data.inputs.size() - next_input.load());
+
+  partitions.planners = workers;
+  for (idx_t i = 0; i < workers; ++i)
+    planners.emplace_back(&PSTReadGlobalState::plan_remaining_inputs, this);
+}
+
+PSTReadGlobalState::~PSTReadGlobalState() {
+  cancelled = true;
+  planner_signal->notify();
+  for (auto &planner : planners)
+    planner.join();
 }
 
-std::optional<PSTInputPartition> PSTReadGlobalState::take_partition() {
-  auto sync_partitions = partitions.synchronize();
-  if (sync_partitions->empty())
-    return {};
+void PSTReadGlobalState::plan_remaining_inputs() {
+  auto cache_usage = pst::BlockCache::thread_usage();
+  for (idx_t i = next_input++; i < bind_data.inputs.size(); i = next_input++) {
+    if (remaining_rows() == 0)
+      break;
 
-  auto part = sync_partitions->front();
+    auto &input = bind_data.inputs[i];
+
+    // Files stay open until their partitions are read, so wait for room
+    // before opening another (files wake the planners as they close). The
+    // first file left to plan never waits, as workers may be waiting for it
+    // (and holding files open meanwhile).
+    auto first_unplanned = [&]() {
+      std::lock_guard<std::mutex> guard(partitions_lock);
+      auto queue = partitions.file(input.file.path);
+      for (idx_t file = 0; file < queue; ++file) {
+        if (partitions.unplanned[file] > 0)
+          return false;
+      }
+      return true;
+    };
+
+    while (true) {
+      // Taken before checking, so nothing that happens after is missed
+      auto seen = planner_signal->current();
+      if (cancelled || open_files() < max_open_files || first_unplanned())
+        break;
+      planner_signal->wait(seen);
+    }
+
+    try {
+      bind_data.plan_file_partitions(ctx, input, mount(input), *this);
+    } catch (std::exception &e) {
+      DUCKDB_LOG_ERROR(ctx, "Unable to read PST file (%s): %s",
+                       input.file.path, e.what());
+    }
+
+    // Workers can move on to the next file, and the next file left to plan
+    // no longer waits
+    {
+      std::lock_guard<std::mutex> guard(partitions_lock);
+      --partitions.unplanned[partitions.file(input.file.path)];
+      partitions_ready.notify_all();
+    }
+    planner_signal->notify();
+  }
+
+  count_cache_usage(cache_usage);
+
+  std::lock_guard<std::mutex> guard(partitions_lock);
+  --partitions.planners;
+  partitions_ready.notify_all();
+}
+
+void PSTReadGlobalState::count_cache_usage(
+    const pst::BlockCache::Usage &since) {
+  auto usage = pst::BlockCache::thread_usage();
+  cache_hits += usage.hits - since.hits;
+  cache_misses += usage.misses - since.misses;
+}
+
+shared_ptr<PSTMountedFile>
+PSTReadGlobalState::mount(const PSTInputFile &input) {
+  {
+    std::lock_guard<std::mutex> guard(mounts_lock);
+    if (auto mounted = mounts[input.file_index].lock())
+      return mounted;
+  }
+
+  // Not under the lock, as mounting reads the file. Should two workers mount
+  // the same file, the one to finish last shares the first one's handles.
+  auto mounted = input.mount(ctx);
+
+  std::lock_guard<std::mutex> guard(mounts_lock);
+  auto &slot = mounts[input.file_index];
+  if (auto other = slot.lock())
+    return other;
+
+  // Planners waiting for room to open another file are told when this one
+  // closes
+  mounted->on_release = [signal = planner_signal]() { signal->notify(); };
+  slot = mounted;
+  return mounted;
+}
+
+idx_t PSTReadGlobalState::open_files() {
+  std::lock_guard<std::mutex> guard(mounts_lock);
+  idx_t count = 0;
+  for (auto it = mounts.begin(); it != mounts.end();) {
+    if (it->second.expired()) {
+      it = mounts.erase(it);
+      continue;
+    }
+    ++count;
+    ++it;
+  }
+  return count;
+}
+
+const PSTInputFile &
+PSTReadGlobalState::input_of(const PSTInputPartition &partition) const {
+  auto file_index = partition.partition_index >> PARTITION_ORDINAL_BITS;
+  auto &inputs = bind_data.inputs;
+  auto input = std::lower_bound(inputs.begin(), inputs.end(), file_index,
+                                [](const PSTInputFile &input, idx_t index) {
+                                  return input.file_index < index;
+                                });
+  if (input == inputs.end() || input->file_index != file_index)
+    throw InternalException("No input for partition %d of %s",
+                            partition.partition_index, partition.file.path);
+  return *input;
+}
+
+idx_t PSTReadGlobalState::remaining_rows() {
+  if (cancelled)
+    return 0;
+
+  auto limit = bind_data.read_limit();
+  std::lock_guard<std::mutex> guard(partitions_lock);
+  return limit - std::min(limit, partitions.total_rows);
+}
+
+void PSTReadGlobalState::add_partition(
+    const PSTInputFile &input, const shared_ptr<PSTMountedFile> &mounted,
+    idx_t partition_index, vector<node_id> &&nodes) {
+  std::lock_guard<std::mutex> guard(partitions_lock);
+
+  auto limit = bind_data.read_limit();
+  nodes.resize(std::min<idx_t>(
+      nodes.size(), limit - std::min(limit, partitions.total_rows)));
+  if (nodes.empty())
+    return;
+
+  PartitionStatistics stats;
+  stats.row_start = partitions.total_rows;
+  stats.count = nodes.size();
+  stats.count_type = CountType::COUNT_EXACT;
+
+  partitions.total_rows += nodes.size();
+  ++partitions.partition_count;
+  partitions.push(PSTInputPartition(partition_index, mounted, input.file,
+                                    bind_data.mode, stats, std::move(nodes)));
+
+  partitions_ready.notify_one();
+}
+
+void PSTReadGlobalState::preserve_order(bool ordered) {
+  std::lock_guard<std::mutex> guard(partitions_lock);
+  this->ordered = ordered;
+}
+
+idx_t PSTReadGlobalState::partitions_planned() {
+  std::lock_guard<std::mutex> guard(partitions_lock);
+  return partitions.partition_count;
+}
+
+shared_ptr<PSTPartitionScan>
+PSTReadGlobalState::take_partition(const PSTPartitionScan *current) {
+  std::unique_lock<std::mutex> guard(partitions_lock);
+  auto &files = partitions.files;
+
+  // Ordered reads take from the first file that isn't done. Unordered reads
+  // stay on the worker's file (its pst copy is bound to it), or else take
+  // from the first file with partitions queued.
+  auto ready_queue = [&]() -> idx_t {
+    if (ordered)
+      return partitions.next_file < files.size() &&
+                     !files[partitions.next_file].empty()
+                 ? partitions.next_file
+                 : files.size();
+
+    if (current) {
+      auto queue = partitions.file_index.find(current->file.path);
+      if (queue != partitions.file_index.end() && !files[queue->second].empty())
+        return queue->second;
+    }
+
+    for (auto queue = partitions.next_file; queue < files.size(); ++queue) {
+      if (!files[queue].empty())
+        return queue;
+    }
+    return files.size();
+  };
+
+  idx_t next_queue;
+  while (true) {
+    // Files are done once planned and handed out (or once planning stops,
+    // e.g. at read_limit)
+    while (partitions.next_file < files.size() &&
+           files[partitions.next_file].empty() &&
+           (partitions.unplanned[partitions.next_file] == 0 ||
+            partitions.planners == 0))
+      ++partitions.next_file;
+
+    next_queue = ready_queue();
+    if (partitions.next_file == files.size() || next_queue < files.size())
+      break;
+
+    // The file's planner is behind: help whoever has the most left
+    if (auto stolen = steal_partition(current))
+      return stolen;
+
+    partitions_ready.wait(guard);
+  }
+
+  // Every file is done, but workers may still be busy with their last
+  // partitions
+  if (next_queue == files.size())
+    return steal_partition(current);
+
+  auto &file_queue = files[next_queue];
+  auto part = make_shared_ptr<PSTPartitionScan>(file_queue.front(),
+                                                partitions.sequence++);
 
   // TODO: it would be more honest if this happened after emission
-  nodes_processed += part.stats.count;
+  nodes_processed += part->stats.count;
 
-  sync_partitions->pop();
-  return std::move(part);
+  file_queue.pop_front();
+
+  // Partitions planned before the scan don't hold their file open
+  if (!part->mounted) {
+    guard.unlock();
+    part->mounted = mount(input_of(*part));
+    guard.lock();
+  }
+
+  running.push_back(part);
+  return part;
+}
+
+shared_ptr<PSTPartitionScan>
+PSTReadGlobalState::steal_partition(const PSTPartitionScan *current) {
+  // Workers of ordered reads only ever move forward (see batch_index), the
+  // others can take over the tail of any partition
+  std::optional<std::pair<idx_t, idx_t>> after;
+  if (ordered && current)
+    after = current->order();
+
+  shared_ptr<PSTPartitionScan> victim;
+  idx_t most_remaining = 0;
+
+  for (auto it = running.begin(); it != running.end();) {
+    auto scan = it->lock();
+    if (!scan) {
+      it = running.erase(it);
+      continue;
+    }
+
+    auto remaining = scan->remaining();
+    if (remaining > most_remaining && (!after || scan->order() >= *after)) {
+      most_remaining = remaining;
+      victim = std::move(scan);
+    }
+    ++it;
+  }
+
+  if (!victim)
+    return nullptr;
+
+  // The owner may have claimed the rest in the meantime
+  idx_t position;
+  auto nodes = victim->steal(after, position);
+  if (nodes.empty())
+    return nullptr;
+
+  // Its nodes were already counted as processed when the victim took it
+  auto stats = victim->stats;
+  stats.count = nodes.size();
+
+  auto part = make_shared_ptr<PSTPartitionScan>(
+      PSTInputPartition(victim->partition_index, victim->mounted, victim->file,
+                        victim->mode, stats, std::move(nodes)),
+      victim->sequence, position);
+  running.push_back(part);
+  return part;
 }
 
 idx_t PSTReadGlobalState::MaxThreads() const {
-  return std::max<idx_t>(partitions->size(), 1);
+  return std::max<idx_t>(max_threads, 1);
+}
+
+/**
+ * @brief Can a value pass a table filter? Filters that can't be checked
+ * against a single value (or join filters that aren't set yet) let it
+ * through.
+ */
+static bool filter_may_match(const TableFilter &filter, const Value &value) {
+  switch (filter.filter_type) {
+  case TableFilterType::CONSTANT_COMPARISON: {
+    auto &constant = filter.Cast<ConstantFilter>();
+    return constant.constant.type() != value.type() ||
+           constant.Compare(value);
+  }
+  case TableFilterType::IN_FILTER: {
+    auto &in = filter.Cast<InFilter>();
+    return in.values.empty() || in.values[0].type() != value.type() ||
+           std::find(in.values.begin(), in.values.end(), value) !=
+               in.values.end();
+  }
+  case TableFilterType::CONJUNCTION_AND: {
+    for (auto &child : filter.Cast<ConjunctionAndFilter>().child_filters) {
+      if (!filter_may_match(*child, value))
+        return false;
+    }
+    return true;
+  }
+  case TableFilterType::CONJUNCTION_OR: {
+    for (auto &child : filter.Cast<ConjunctionOrFilter>().child_filters) {
+      if (filter_may_match(*child, value))
+        return true;
+    }
+    return false;
+  }
+  case TableFilterType::OPTIONAL_FILTER: {
+    auto &child = filter.Cast<OptionalFilter>().child_filter;
+    return !child || filter_may_match(*child, value);
+  }
+  case TableFilterType::DYNAMIC_FILTER: {
+    auto &data = filter.Cast<DynamicFilter>().filter_data;
+    if (!data)
+      return true;
+
+    std::lock_guard<std::mutex> guard(data->lock);
+    return !data->initialized || !data->filter ||
+           filter_may_match(*data->filter, value);
+  }
+  default:
+    return true;
+  }
+}
+
+bool PSTReadGlobalState::may_match(column_t column, const Value &value) const {
+  if (!table_filters)
+    return true;
+
+  for (auto &[index, filter] : table_filters->filters) {
+    if (index < column_ids.size() && column_ids[index] == column &&
+        !filter_may_match(*filter, value))
+      return false;
+  }
+  return true;
+}
+
+idx_t PSTReadGlobalState::batch_index(const PSTPartitionScan &scan) const {
+  // DuckDB takes batch indexes below 10^13 (and they must only ever grow, so
+  // they can't wrap)
+  if (scan.sequence >= (idx_t(1) << (43 - offset_bits)))
+    throw InvalidInputException(
+        "Too many partitions to preserve insertion order, use a smaller "
+        "partition_size or SET preserve_insertion_order = false");
+
+  return (scan.sequence << offset_bits) | scan.offset;
+}
+
+unique_ptr<Expression>
+PSTReadGlobalState::filter_expression(const vector<LogicalType> &types) const {
+  if (!table_filters || table_filters->filters.empty())
+    return nullptr;
+
+  auto conjunction =
+      make_uniq<BoundConjunctionExpression>(ExpressionType::CONJUNCTION_AND);
+  for (auto &[index, filter] : table_filters->filters) {
+    BoundReferenceExpression column(types[index], index);
+    conjunction->children.push_back(filter->ToExpression(column));
+  }
+
+  if (conjunction->children.size() == 1)
+    return std::move(conjunction->children[0]);
+  return std::move(conjunction);
 }
 
 // PSTReadLocalState
 PSTReadLocalState::PSTReadLocalState(PSTReadGlobalState &global_state,
                                      ExecutionContext &ec)
     : global_state(global_state), ec(ec) {
-  bind_partition();
-  if (partition.has_value()) {
-    current.emplace(partition->nodes.begin());
-    end.emplace(partition->nodes.end());
-  }
+  // Only sinks that need batch indexes (e.g. to preserve insertion order)
+  // need partitions in order
+  optional_ptr<PhysicalOperator> sink;
+  if (ec.pipeline)
+    sink = ec.pipeline->GetSink();
+  global_state.preserve_order(!sink ||
+                              sink->RequiredPartitionInfo().batch_index);
+
+  if (bind_partition())
+    start_partition();
 }
 
 bool PSTReadLocalState::bind_partition() {
-  auto next_partition = global_state.take_partition();
-  if (!next_partition.has_value())
+  auto next_partition = global_state.take_partition(partition.get());
+  if (!next_partition)
     return false;
 
-  bool skip_bind_pst = partition.has_value() &&
-                       (next_partition->file.path == partition->file.path);
-  partition.emplace(std::move(*next_partition));
-  if (!skip_bind_pst)
-    pst.emplace(pstsdk::pst(*partition->pst));
+  bool skip_bind_pst =
+      partition && (next_partition->mounted == partition->mounted);
+  partition = std::move(next_partition);
+  if (!skip_bind_pst) {
+    pst.emplace(pstsdk::pst(*partition->mounted->pst));
+    bind_file();
+  }
 
   return true;
 }
@@ -79,54 +615,181 @@ const LogicalType &PSTReadLocalState::output_schema() {
 }
 
 const bool PSTReadLocalState::finished() {
-  return (!current) || (current == end);
+  return !partition || partition->remaining() == 0;
+}
+
+void PSTReadLocalState::start_partition() {
+  // e.g. the row IDs of a late materialized query are all in other partitions
+  if (!global_state.may_match(schema::PST_VCOL_PARTITION_INDEX,
+                              Value::UBIGINT(partition->partition_index)))
+    partition->close();
 }
 
 bool PSTReadLocalState::bind_next() {
   while (finished()) {
     if (!bind_partition())
       return false;
-    current.emplace(partition->nodes.begin());
-    end.emplace(partition->nodes.end());
+    start_partition();
   }
 
   return true;
 }
 
+bool PSTReadLocalState::node_may_match(node_id nid) const {
+  auto value = Value::UINTEGER(nid);
+  return global_state.may_match(schema::PST_VCOL_NODE_ID, value) &&
+         global_state.may_match(
+             static_cast<column_t>(schema::PSTProjection::node_id), value);
+}
+
+bool PSTReadLocalState::in_time_ranges(node_id nid) const {
+  auto &accepted = partition->mounted->in_time_ranges;
+  return accepted && accepted->count(nid) > 0;
+}
+
+void PSTReadLocalState::filter_rows(DataChunk &output) {
+  if (!filter_bound) {
+    // Join filters are set by the time the scan starts, so they're bound
+    // with their values
+    filter = global_state.filter_expression(output.GetTypes());
+    if (filter)
+      filter_executor = make_uniq<ExpressionExecutor>(ec.client, *filter);
+    filter_bound = true;
+  }
+
+  if (!filter_executor || output.size() == 0)
+    return;
+
+  SelectionVector sel(STANDARD_VECTOR_SIZE);
+  auto count = filter_executor->SelectExpression(output, sel);
+  if (count < output.size())
+    output.Slice(sel, count);
+}
+
+void PSTReadLocalState::prefetch_blocks(idx_t count) {
+  // Contents table scans don't read message nodes
+  if (contents_tables || !bind_next() || !partition->mounted->blocks)
+    return;
+
+  auto db = pst->get_db();
+  vector<pst::BlockRange> blocks;
+
+  // Nodes stolen in the meantime are fetched for nothing, which is harmless
+  auto [begin, end] = partition->unread();
+  for (auto i = begin; i < end && count > 0; ++i, --count) {
+    auto nid = partition->nodes[i];
+    if (!node_may_match(nid))
+      continue;
+
+    try {
+      auto node = db->lookup_node_info(nid);
+      for (auto bid : {node.data_bid, node.sub_bid}) {
+        if (bid == 0)
+          continue;
+
+        auto block = db->lookup_block_info(bid);
+        blocks.push_back({block.address, block.size});
+      }
+    } catch (std::exception &) {
+      // Reading the node will report it
+    }
+  }
+
+  partition->mounted->blocks->prefetch(blocks);
+}
+
 // PSTReadConcreteLocalState
 template <pst::MessageClass V, typename T>
 PSTReadConcreteLocalState<V, T>::PSTReadConcreteLocalState(
     PSTReadGlobalState &global_state, ExecutionContext &ec)
-    : PSTReadLocalState(global_state, ec) {}
+    : PSTReadLocalState(global_state, ec),
+      column_plan(row_serializer::plan_columns<pst::TypedBag<V, T>>(
+          global_state.column_indexes)) {
+  if (global_state.reads_contents_tables())
+    contents_tables.emplace();
+
+  // The base constructor already bound the first partition, but couldn't
+  // dispatch to us
+  if (partition)
+    bind_file();
+}
 
 template <pst::MessageClass V, typename T>
-std::optional<pst::TypedBag<V, T>> PSTReadConcreteLocalState<V, T>::next() {
-  // If the current state is finished, keep going until we can keep binding
-  while (finished() && bind_next()) {
+void PSTReadConcreteLocalState<V, T>::bind_file() {
+  for (auto &reader : column_plan.readers) {
+    if (reader.source != row_serializer::PropSource::Named)
+      continue;
+
+    reader.prop = partition->mounted->named_props->resolve(
+        *pst, *reader.named_set, reader.named_id);
   }
 
-  // If we can't bind anymore and are finished, we're really finished
-  if (finished())
-    return {};
+  if (!contents_tables)
+    return;
 
-  pst::TypedBag<V, T> typed_bag(*pst, **current);
+  // Contents tables of this file need columns for all the props read
+  vector<pstsdk::prop_id> props;
+  for (auto &reader : column_plan.readers) {
+    if (reader.source == row_serializer::PropSource::Bag ||
+        reader.source == row_serializer::PropSource::Named)
+      props.push_back(reader.prop);
+  }
+  contents_tables->reset(std::move(props),
+                         partition->mounted->contents_rows);
+}
 
-  ++(*current);
-  return typed_bag;
+template <pst::MessageClass V, typename T>
+std::optional<pst::TypedBag<V, T>>
+PSTReadConcreteLocalState<V, T>::next(bool bind) {
+  std::optional<node_id> nid;
+  do {
+    // If the current state is finished, keep going until we can keep binding
+    while (bind && finished() && bind_next()) {
+    }
+
+    // If we can't bind anymore and are finished, we're really finished
+    if (finished())
+      return {};
+
+    // Empty if another worker stole the rest of the partition
+    nid = partition->claim();
+
+    // Nodes ruled out by filters on node_id (e.g. the join of a late
+    // materialized query) are never read
+  } while (!nid || !node_may_match(*nid));
+
+  if (contents_tables) {
+    node_id folder_id = 0;
+    auto row = contents_tables->lookup(*pst, *nid, folder_id);
+    return pst::TypedBag<V, T>(*pst, *nid, std::move(row), folder_id);
+  }
+
+  return pst::TypedBag<V, T>(*pst, *nid);
 }
 
 template <pst::MessageClass V, typename T>
 idx_t PSTReadConcreteLocalState<V, T>::emit_rows(DataChunk &output) {
   idx_t rows = 0;
+  auto &filters = global_state.bind_data.filters;
 
-  for (idx_t i = 0; i < STANDARD_VECTOR_SIZE; ++i) {
-    auto item = next();
+  prefetch_blocks(STANDARD_VECTOR_SIZE);
+
+  while (rows < STANDARD_VECTOR_SIZE) {
+    // Chunks don't span partitions, so each has one batch index
+    auto item = next(rows == 0);
 
     if (!item) {
       break;
     }
 
-    row_serializer::into_row<pst::TypedBag<V, T>>(*this, output, *item, i);
+    // Rows outside pushed down time ranges are dropped before any column is
+    // read (unless planning found them within the ranges by their rows)
+    if (!filters.time_ranges.empty() && !in_time_ranges(item->nid) &&
+        !filters.matches_times(item->bag()))
+      continue;
+
+    row_serializer::into_row<pst::TypedBag<V, T>>(*this, column_plan, output,
+                                                  *item, rows);
 
     ++rows;
   }
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "duckdb/common/constants.hpp"
+#include "duckdb/common/types/vector.hpp"
+#include "duckdb/common/vector.hpp"
+#include "pstsdk/util/primitives.h"
+
+#include <cstdint>
+
+namespace intellekt::duckpst {
+class PSTReadLocalState;
+
+namespace row_serializer {
+using namespace duckdb;
+
+/**
+ * @brief Where a column's value lives
+ *
+ */
+enum class PropSource : uint8_t {
+  // Derived from the pstsdk object or the scan state
+  Computed,
+  // A MAPI prop on the item's prop bag
+  Bag,
+  // A MAPI prop on the PST message store
+  Store,
+  // A named prop (PSETID + LID) on the item's prop bag
+  Named
+};
+
+template <typename Item> struct ColumnReader;
+
+/**
+ * @brief Static description of a table function column, generated from the
+ * schema x-macros (one constexpr table per TypedBag variant)
+ *
+ * @tparam Item A TypedBag variant
+ */
+template <typename Item> struct ColumnDescriptor {
+  using read_fn = void (*)(PSTReadLocalState &local_state,
+                           const ColumnReader<Item> &reader, Item &item,
+                           Vector &target, idx_t row_number);
+
+  PropSource source;
+
+  // Converter that writes the cell
+  read_fn read;
+
+  // MAPI property ID (unused by computed columns)
+  pstsdk::prop_id prop;
+
+  // Named properties (PSETID + LID) are mapped to a prop ID per PST file,
+  // which is then stored in prop (see PSTReadLocalState::bind_file)
+  const pstsdk::guid *named_set;
+  long named_id;
+};
+
+/**
+ * @brief A projected column, resolved once per scan against the output schema
+ * so the per-row loop doesn't have to switch on the schema ordinal
+ *
+ * @tparam Item A TypedBag variant
+ */
+template <typename Item> struct ColumnReader : ColumnDescriptor<Item> {
+  // Output chunk vector, and its position in the table function schema
+  idx_t column_index;
+  column_t schema_col;
+
+  // Projected fields of a (LIST of) STRUCT column, empty if all are read
+  vector<idx_t> struct_fields;
+};
+
+/**
+ * @brief Readers for all projected columns of a scan
+ *
+ * @tparam Item A TypedBag variant
+ */
+template <typename Item> struct ColumnPlan {
+  vector<ColumnReader<Item>> readers;
+
+  // List each row's props in one pass first, so converters for absent props
+  // can be skipped (only worth it for wide projections)
+  bool list_props = false;
+
+  // Every column can be read from folder contents tables, without opening
+  // message nodes (see PSTScanMode::Auto)
+  bool contents_table = true;
+};
+
+} // namespace row_serializer
+} // namespace intellekt::duckpst
@@ -0,0 +1,171 @@
+#pragma once
+
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/types.hpp"
+#include "duckdb/common/types/string_type.hpp"
+#include "duckdb/common/types/timestamp.hpp"
+#include "duckdb/common/types/value.hpp"
+#include "duckdb/common/types/vector.hpp"
+#include "pstsdk/util/primitives.h"
+#include "pstsdk/util/util.h"
+
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief Typed writers that target the flat output vectors of a DataChunk
+ * directly, so the serializer never boxes a cell into a duckdb::Value
+ *
+ */
+namespace intellekt::duckpst::column_writer {
+using namespace duckdb;
+
+/**
+ * @brief Mark a cell as NULL
+ *
+ * @param vec Target (flat) output vector
+ * @param row Row number
+ */
+inline void write_null(Vector &vec, idx_t row) {
+  FlatVector::SetNull(vec, row, true);
+}
+
+/**
+ * @brief Write a numeric value, casting to the physical type of the column
+ * (this also covers ENUM indexes, BOOLEAN and TIMESTAMP_S seconds)
+ *
+ * @tparam T Any arithmetic type
+ * @param vec Target (flat) output vector
+ * @param row Row number
+ * @param value Value to write
+ */
+template <typename T>
+inline void write_numeric(Vector &vec, idx_t row, const T value) {
+  static_assert(std::is_arithmetic_v<T>, "write_numeric requires a number");
+
+  switch (vec.GetType().InternalType()) {
+  case PhysicalType::BOOL:
+    FlatVector::GetData<bool>(vec)[row] = value != 0;
+    break;
+  case PhysicalType::INT8:
+    FlatVector::GetData<int8_t>(vec)[row] = static_cast<int8_t>(value);
+    break;
+  case PhysicalType::INT16:
+    FlatVector::GetData<int16_t>(vec)[row] = static_cast<int16_t>(value);
+    break;
+  case PhysicalType::INT32:
+    FlatVector::GetData<int32_t>(vec)[row] = static_cast<int32_t>(value);
+    break;
+  case PhysicalType::INT64:
+    FlatVector::GetData<int64_t>(vec)[row] = static_cast<int64_t>(value);
+    break;
+  case PhysicalType::UINT8:
+    FlatVector::GetData<uint8_t>(vec)[row] = static_cast<uint8_t>(value);
+    break;
+  case PhysicalType::UINT16:
+    FlatVector::GetData<uint16_t>(vec)[row] = static_cast<uint16_t>(value);
+    break;
+  case PhysicalType::UINT32:
+    FlatVector::GetData<uint32_t>(vec)[row] = static_cast<uint32_t>(value);
+    break;
+  case PhysicalType::UINT64:
+    FlatVector::GetData<uint64_t>(vec)[row] = static_cast<uint64_t>(value);
+    break;
+  case PhysicalType::FLOAT:
+    FlatVector::GetData<float>(vec)[row] = static_cast<float>(value);
+    break;
+  case PhysicalType::DOUBLE:
+    FlatVector::GetData<double>(vec)[row] = static_cast<double>(value);
+    break;
+  default:
+    throw InvalidInputException(
+        "Unsupported column type %s. Please report this bug on GitHub.",
+        vec.GetType().ToString());
+  }
+}
+
+/**
+ * @brief Write raw bytes into a VARCHAR or BLOB column. VARCHAR columns are
+ * checked for valid UTF-8 (same as duckdb::Value would)
+ *
+ * @param vec Target (flat) output vector
+ * @param row Row number
+ * @param data Pointer to bytes
+ * @param size Number of bytes
+ */
+inline void write_string(Vector &vec, idx_t row, const char *data, idx_t size) {
+  if (vec.GetType().id() == LogicalTypeId::VARCHAR &&
+      !Value::StringIsValid(data, size)) {
+    throw InvalidInputException(
+        "Invalid unicode (byte sequence mismatch) detected in string");
+  }
+
+  FlatVector::GetData<string_t>(vec)[row] =
+      StringVector::AddStringOrBlob(vec, string_t(data, size));
+}
+
+/**
+ * @brief Write a string that already lives in the vector's string heap (see
+ * StringVector::EmptyString), without copying it again
+ *
+ * @param vec Target (flat) output vector
+ * @param row Row number
+ * @param value String backed by the vector's heap (or inlined)
+ */
+inline void write_string_t(Vector &vec, idx_t row, string_t value) {
+  if (vec.GetType().id() == LogicalTypeId::VARCHAR &&
+      !Value::StringIsValid(value.GetData(), value.GetSize())) {
+    throw InvalidInputException(
+        "Invalid unicode (byte sequence mismatch) detected in string");
+  }
+
+  FlatVector::GetData<string_t>(vec)[row] = value;
+}
+
+inline void write_string(Vector &vec, idx_t row, const std::string &value) {
+  write_string(vec, row, value.data(), value.size());
+}
+
+inline void write_string(Vector &vec, idx_t row,
+                         const std::vector<pstsdk::byte> &value) {
+  write_string(vec, row, reinterpret_cast<const char *>(value.data()),
+               value.size());
+}
+
+/**
+ * @brief Write a MAPI property value, converting FILETIMEs to TIMESTAMP_S and
+ * bounds checking ENUM indexes
+ *
+ * @tparam T e.g., int32_t, pstsdk::ulonglong, or std::string
+ * @param vec Target (flat) output vector
+ * @param row Row number
+ * @param value Property value
+ */
+template <typename T>
+inline void write_prop_value(Vector &vec, idx_t row, const T &value) {
+  auto &t = vec.GetType();
+
+  if constexpr (std::is_integral_v<T>) {
+    if (t.id() == LogicalTypeId::ENUM) {
+      if constexpr (std::is_signed_v<T>) {
+        if (value < 0)
+          return write_null(vec, row);
+      }
+      if (static_cast<uint64_t>(value) >= EnumType::GetSize(t))
+        return write_null(vec, row);
+    } else if (t.id() == LogicalTypeId::TIMESTAMP_SEC) {
+      time_t unixtime = pstsdk::filetime_to_time_t(value);
+      FlatVector::GetData<timestamp_sec_t>(vec)[row] =
+          timestamp_sec_t(unixtime);
+      return;
+    }
+    write_numeric(vec, row, value);
+  } else if constexpr (std::is_floating_point_v<T>) {
+    write_numeric(vec, row, value);
+  } else {
+    write_string(vec, row, value);
+  }
+}
+
+} // namespace intellekt::duckpst::column_writer
@@ -1,38 +1,354 @@
 #pragma once
 
+#include "column_plan.hpp"
+#include "pst/block_cache.hpp"
+#include "pst/contents_table.hpp"
 #include "duckdb/common/typedefs.hpp"
+#include "duckdb/execution/expression_executor.hpp"
 #include "duckdb/function/table_function.hpp"
+#include "duckdb/planner/table_filter.hpp"
 #include "pst/typed_bag.hpp"
 #include "table_function.hpp"
 
 #include <boost/thread/synchronized_value.hpp>
 #include <pstsdk/pst.h>
 
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+
 namespace intellekt::duckpst {
 using namespace duckdb;
 using namespace pstsdk;
 
 /**
- * The global PST read state is a queue of input partitions, where the progress
- * of the read is determined by the number of NDB nodes spooled.
+ * @brief Input partitions queued per file (in glob order). When the order of
+ * the read matters, they are handed out a file at a time so the read follows
+ * the order of the files and their nodes.
+ */
+struct PSTFilePartitionQueues {
+  vector<std::deque<PSTInputPartition>> files;
+  unordered_map<string, idx_t> file_index;
+
+  // Inputs of each file still to be planned
+  vector<idx_t> unplanned;
+
+  // Files before this one are planned, and have no partitions left
+  idx_t next_file = 0;
+
+  // Partitions and rows planned so far (before and while scanning)
+  idx_t partition_count = 0;
+  idx_t total_rows = 0;
+
+  // Partitions handed out so far
+  idx_t sequence = 0;
+
+  // Planner threads still producing partitions
+  idx_t planners = 0;
+
+  /**
+   * @brief Get the queue of a file, adding it after the others if it's new
+   *
+   * @param path
+   * @return idx_t
+   */
+  idx_t file(const string &path);
+
+  void push(PSTInputPartition &&part);
+};
+
+/**
+ * @brief Wakes planners waiting for room to open another file. Files release
+ * it from any thread (possibly holding partitions_lock), and may outlive the
+ * read, so it has a lock of its own and is shared with them.
  */
-class PSTReadGlobalState : public GlobalTableFunctionState {
-  boost::synchronized_value<queue<PSTInputPartition>> partitions;
+struct PSTPlannerSignal {
+  std::mutex lock;
+  std::condition_variable changed;
+
+  // Bumped on every event planners may be waiting for
+  idx_t generation = 0;
+
+  idx_t current() {
+    std::lock_guard<std::mutex> guard(lock);
+    return generation;
+  }
+
+  void notify() {
+    {
+      std::lock_guard<std::mutex> guard(lock);
+      ++generation;
+    }
+    changed.notify_all();
+  }
+
+  /**
+   * @brief Wait until something happened since a generation was seen
+   *
+   * @param seen
+   */
+  void wait(idx_t seen) {
+    std::unique_lock<std::mutex> guard(lock);
+    changed.wait(guard, [&]() { return generation != seen; });
+  }
+};
+
+/**
+ * @brief A partition being spooled by a worker. Its unread nodes are a range
+ * of positions packed into one atomic word (begin in the high half, end in
+ * the low half): the worker claims nodes off the front, and idle workers
+ * steal the back half, neither taking a lock.
+ *
+ * Scans are ordered by the sequence their partition was handed out in, then
+ * by the position of their first node in it, which is the order of their
+ * rows in the read.
+ */
+struct PSTPartitionScan : public PSTInputPartition {
+  std::atomic<uint64_t> range;
+
+  // Hand out sequence of the (original) partition
+  const idx_t sequence;
+
+  // Position of nodes[0] in the original partition (0 unless stolen)
+  const idx_t offset;
+
+  PSTPartitionScan(const PSTInputPartition &partition, idx_t sequence,
+                   idx_t offset = 0);
+
+  std::pair<idx_t, idx_t> order() const { return {sequence, offset}; }
+
+  /**
+   * @brief Claim the next unread node
+   *
+   * @return std::optional<node_id> Empty once the range is exhausted (or
+   * stolen)
+   */
+  std::optional<node_id> claim();
+
+  /**
+   * @brief Take the back half of the unread nodes (all of them if only one
+   * is left)
+   *
+   * @param after Only steal nodes ordered after this (the thief's last scan
+   * of an ordered read), if set
+   * @param position Set to the position of the first stolen node
+   * @return vector<node_id> Empty if there was nothing left to steal
+   */
+  vector<node_id> steal(const std::optional<std::pair<idx_t, idx_t>> &after,
+                        idx_t &position);
+
+  /**
+   * @brief Positions of the unread nodes, [begin, end)
+   */
+  std::pair<idx_t, idx_t> unread() const;
+
+  idx_t remaining() const;
+
+  /**
+   * @brief Drop the unread nodes (e.g. when filters rule them all out)
+   */
+  void close();
+};
+
+/**
+ * The global PST read state is a set of per-file queues of input partitions,
+ * where the progress of the read is determined by the number of NDB nodes
+ * spooled.
+ *
+ * Files not planned before the scan are planned by a bounded pool of planner
+ * threads (one file each at a time), whose partitions are queued as soon as
+ * they are formed, so scans start while planning continues. Files are mounted
+ * by their planner (or when their first partition is handed out), and closed
+ * once their last partition is read.
+ *
+ * When the operator the scan feeds needs batch indexes, partitions are
+ * handed out in file (glob) order, and nodes are planned in ascending NID
+ * order, so every scan has a batch index and insertion order is files, then
+ * node_id (contents table scans order the nodes within each partition by
+ * folder and table row instead). Otherwise workers take partitions of any
+ * planned file.
+ *
+ * Once the queues run dry, idle workers split the partition with the most
+ * unread nodes and take over its tail, so a worker stuck on heavy messages
+ * doesn't leave the rest of its partition to the end of the query. In ordered
+ * reads, the tail has to come after the thief's own last scan, as batch
+ * indexes only ever grow per worker.
+ */
+class PSTReadGlobalState : public GlobalTableFunctionState,
+                           public PSTPartitionSink {
+  ClientContext &ctx;
+
+  std::mutex partitions_lock;
+  std::condition_variable partitions_ready;
+  PSTFilePartitionQueues partitions;
+
+  idx_t max_threads;
+
+  // Partitions being spooled, whose tails can be stolen
+  vector<weak_ptr<PSTPartitionScan>> running;
+
+  // Batch indexes are a scan's sequence, then this many bits of its offset
+  idx_t offset_bits;
+
+  std::atomic<bool> cancelled{false};
+  std::atomic<idx_t> next_input{0};
+  vector<std::thread> planners;
+
+  // Mounted files by glob position. A file stays open while partitions of it
+  // are queued or read, and planners wait to mount more than max_open_files
+  // until a file is closed (or an earlier file is planned).
+  std::mutex mounts_lock;
+  unordered_map<idx_t, weak_ptr<PSTMountedFile>> mounts;
+  idx_t max_open_files;
+  std::shared_ptr<PSTPlannerSignal> planner_signal;
+
+  /**
+   * @brief Mount an input, or share its handles if it's still open
+   *
+   * @param input
+   * @return shared_ptr<PSTMountedFile>
+   */
+  shared_ptr<PSTMountedFile> mount(const PSTInputFile &input);
+
+  /**
+   * @brief Number of mounted files still open
+   *
+   * @return idx_t
+   */
+  idx_t open_files();
+
+  /**
+   * @brief The input a partition was planned from
+   *
+   * @param partition
+   * @return const PSTInputFile&
+   */
+  const PSTInputFile &input_of(const PSTInputPartition &partition) const;
+
+  // Filters pushed into the scan (filter_pushdown), keyed by output column
+  optional_ptr<TableFilterSet> table_filters;
+
+  // Are message rows read from folder contents tables (see PSTScanMode)?
+  bool contents_scan;
+
+  // Does the operator the scan feeds need batch indexes (e.g. to preserve
+  // insertion order)? Until a worker can tell, assume it does.
+  std::atomic<bool> ordered{true};
+
+  /**
+   * @brief Plan the inputs left unplanned, one at a time (runs on each planner
+   * thread)
+   */
+  void plan_remaining_inputs();
+
+  /**
+   * @brief Split the running partition with the most unread nodes (after the
+   * worker's current scan, for ordered reads) with partitions_lock held
+   *
+   * @param current The worker's current scan, if any
+   * @return shared_ptr<PSTPartitionScan> Its stolen tail, keeping its
+   * partition index (so row IDs are the same whoever reads a node), or NULL
+   * if no partition has nodes left
+   */
+  shared_ptr<PSTPartitionScan> steal_partition(const PSTPartitionScan *current);
 
 public:
-  PSTReadGlobalState(const PSTReadTableFunctionData &bind_data,
-                     vector<column_t> column_ids);
+  PSTReadGlobalState(ClientContext &ctx,
+                     const PSTReadTableFunctionData &bind_data,
+                     vector<column_t> column_ids,
+                     vector<ColumnIndex> column_indexes,
+                     optional_ptr<TableFilterSet> table_filters);
+  ~PSTReadGlobalState() override;
+
   const PSTReadTableFunctionData &bind_data;
 
-  std::optional<PSTInputPartition> take_partition();
+  /**
+   * @brief Dequeue the next partition. For ordered reads, that's the next
+   * partition of the first file that isn't done: workers only move on to the
+   * next file once this one is planned and handed out, steal from other
+   * workers while the file's planner catches up, and wait for it when there
+   * is nothing to steal either. Unordered reads take from the worker's
+   * current file, or else from any planned file.
+   *
+   * @param current The worker's current scan, if any
+   * @return shared_ptr<PSTPartitionScan> NULL once the read is done
+   */
+  shared_ptr<PSTPartitionScan>
+  take_partition(const PSTPartitionScan *current);
+
+  /**
+   * @brief Set whether the read must hand out partitions in order, as told
+   * by the operator the scan feeds
+   *
+   * @param ordered
+   */
+  void preserve_order(bool ordered);
+
+  /**
+   * @brief Number of partitions planned so far
+   *
+   * @return idx_t
+   */
+  idx_t partitions_planned();
+
+  idx_t remaining_rows() override;
+  bool builds_index() const override { return true; }
+  bool reads_contents_tables() const override { return contents_scan; }
+  void add_partition(const PSTInputFile &input,
+                     const shared_ptr<PSTMountedFile> &mounted,
+                     idx_t partition_index,
+                     vector<node_id> &&nodes) override;
+
+  /**
+   * @brief Can a row with this value in a column pass the pushed down filters?
+   * Join filters on the row ID columns (e.g. of late materialization) make
+   * this a point lookup, as nodes that can't match are never read.
+   *
+   * @param column Table function column
+   * @param value
+   */
+  bool may_match(column_t column, const Value &value) const;
+
+  /**
+   * @brief Batch index of a scan, for order preserving reads
+   *
+   * @param scan
+   */
+  idx_t batch_index(const PSTPartitionScan &scan) const;
+
+  /**
+   * @brief Pushed down filters as one expression over the output chunk
+   *
+   * @param types Output chunk types
+   * @return unique_ptr<Expression> NULL if there are none
+   */
+  unique_ptr<Expression>
+  filter_expression(const vector<LogicalType> &types) const;
+
+  /**
+   * @brief Count the block cache lookups the calling thread made for this
+   * read since it took a snapshot of its usage
+   *
+   * @param since pst::BlockCache::thread_usage() before the work
+   */
+  void count_cache_usage(const pst::BlockCache::Usage &since);
+
+  // Block cache lookups of this read (rather than of the process)
+  std::atomic<uint64_t> cache_hits{0};
+  std::atomic<uint64_t> cache_misses{0};
 
   idx_t nodes_processed;
   vector<column_t> column_ids;
+  vector<ColumnIndex> column_indexes;
   idx_t MaxThreads() const override;
 };
 
-typedef vector<node_id>::iterator node_id_iterator;
-
 /**
  * The local (per-thread) read state spools node_ids out of a partition,
  * asking for a new one after all nodes have been output.
@@ -41,8 +357,35 @@ class PSTReadLocalState : public LocalTableFunctionState {
 protected:
   PSTReadLocalState(PSTReadGlobalState &global_state, ExecutionContext &ec);
 
-  std::optional<node_id_iterator> current;
-  std::optional<node_id_iterator> end;
+  // Set when message rows are read from folder contents tables
+  std::optional<pst::ContentsTables> contents_tables;
+
+  // Pushed down filters, bound on first use (join filters are only final
+  // once the scan starts)
+  unique_ptr<Expression> filter;
+  unique_ptr<ExpressionExecutor> filter_executor;
+  bool filter_bound = false;
+
+  /**
+   * @brief Start spooling the bound partition, skipping it whole if the
+   * pushed down filters rule its partition index out
+   */
+  void start_partition();
+
+  /**
+   * @brief Can a node pass the pushed down filters on node_id?
+   *
+   * @param nid
+   */
+  bool node_may_match(node_id nid) const;
+
+  /**
+   * @brief Did planning find a message within the pushed down time ranges
+   * (by its contents table row)?
+   *
+   * @param nid
+   */
+  bool in_time_ranges(node_id nid) const;
 
   /**
    * @brief Dequeue a partition from global state
@@ -54,12 +397,26 @@ protected:
 
   bool bind_next();
 
+  /**
+   * @brief Fetch the NDB data and subnode blocks of the next nodes in one
+   * batch, so reading them doesn't stall on each block in turn
+   *
+   * @param count Number of nodes (at most the rest of the partition)
+   */
+  void prefetch_blocks(idx_t count);
+
+  /**
+   * @brief Called after bind_partition mounts a different PST file than the
+   * previous partition used
+   */
+  virtual void bind_file() {}
+
 public:
   ExecutionContext &ec;
   PSTReadGlobalState &global_state;
 
   std::optional<pstsdk::pst> pst;
-  std::optional<PSTInputPartition> partition;
+  shared_ptr<PSTPartitionScan> partition;
 
   /**
    * @brief Is this partition done?
@@ -77,6 +434,14 @@ public:
    */
   virtual idx_t emit_rows(DataChunk &output) = 0;
 
+  /**
+   * @brief Drop the rows of an emitted chunk that fail the pushed down
+   * filters
+   *
+   * @param output
+   */
+  void filter_rows(DataChunk &output);
+
   const vector<column_t> &column_ids();
   const LogicalType &output_schema();
 };
@@ -89,6 +454,12 @@ public:
  */
 template <pst::MessageClass V, typename T = pstsdk::message>
 class PSTReadConcreteLocalState : public PSTReadLocalState {
+  // Readers for the projected columns, resolved once at init (and named prop
+  // IDs once per file)
+  row_serializer::ColumnPlan<pst::TypedBag<V, T>> column_plan;
+
+  void bind_file() override;
+
 public:
   PSTReadConcreteLocalState(PSTReadGlobalState &global_state,
                             ExecutionContext &ec);
@@ -98,9 +469,10 @@ public:
   /**
    * @brief Get the next item and move the iterator
    *
+   * @param bind Move on to the next partition when this one is done
    * @return std::optional<t>
    */
-  std::optional<pst::TypedBag<V, T>> next();
+  std::optional<pst::TypedBag<V, T>> next(bool bind = true);
 };
 
 } // namespace intellekt::duckpst
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "pstsdk/util/primitives.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace intellekt::duckpst::pst {
+
+/**
+ * @brief Process-wide, size-bounded LRU cache of PST file reads, shared by
+ * every scan thread (and every per-thread pstsdk::pst copy).
+ *
+ * pstsdk reads NBT/BBT pages and data blocks at fixed offsets, so entries are
+ * keyed by (file identity, offset, length). The cache is split into shards,
+ * each with its own lock, to keep contention down under parallel scans.
+ */
+class BlockCache {
+public:
+  static constexpr size_t DEFAULT_CAPACITY = 64 * 1024 * 1024;
+
+  // Reads larger than this (attachment or body data trees are read block by
+  // block, so this is rare) bypass the cache
+  static constexpr size_t MAX_ENTRY_SIZE = 64 * 1024;
+
+  /**
+   * @brief Lookups served from (or missing) the cache
+   */
+  struct Usage {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+  };
+
+  /**
+   * @brief The cache shared by all scans in this process
+   *
+   * @return BlockCache&
+   */
+  static BlockCache &instance();
+
+  /**
+   * @brief Get a stable ID for a file, given a string identifying its path
+   * and version (e.g. size and modification time). IDs are hashes of the
+   * identity, so the cache keeps no state per file ever read.
+   *
+   * @param identity
+   * @return uint64_t
+   */
+  static uint64_t file_id(const std::string &identity);
+
+  /**
+   * @brief Copy a cached read into buffer, if present. The buffer's size is
+   * the length of the read.
+   *
+   * @return true if the read was served from the cache
+   */
+  bool lookup(uint64_t file_id, pstsdk::ulonglong offset,
+              std::vector<pstsdk::byte> &buffer);
+
+  /**
+   * @brief Is a read cached? (doesn't count as a hit or miss)
+   */
+  bool contains(uint64_t file_id, pstsdk::ulonglong offset, size_t size);
+
+  /**
+   * @brief Cache the result of a read, evicting least recently used entries
+   * of its shard as needed
+   */
+  void insert(uint64_t file_id, pstsdk::ulonglong offset,
+              const std::vector<pstsdk::byte> &buffer);
+
+  /**
+   * @brief Set the memory budget (in bytes) of the cache. Zero disables it.
+   *
+   * @param capacity
+   */
+  void set_capacity(size_t capacity);
+
+  size_t capacity() const { return total_capacity.load(); }
+  uint64_t hits() const { return hit_count.load(); }
+  uint64_t misses() const { return miss_count.load(); }
+
+  /**
+   * @brief Lookups of the calling thread so far. A scan sums the difference
+   * over the work it does, as the process-wide counts include other scans.
+   *
+   * @return Usage
+   */
+  static Usage thread_usage();
+
+private:
+  static constexpr size_t NUM_SHARDS = 16;
+
+  struct Key {
+    uint64_t file_id;
+    pstsdk::ulonglong offset;
+    size_t size;
+
+    bool operator==(const Key &other) const {
+      return file_id == other.file_id && offset == other.offset &&
+             size == other.size;
+    }
+  };
+
+  struct KeyHash {
+    size_t operator()(const Key &key) const;
+  };
+
+  struct Entry {
+    Key key;
+    std::vector<pstsdk::byte> data;
+  };
+
+  struct Shard {
+    std::mutex lock;
+    std::list<Entry> lru;
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> entries;
+    size_t size = 0;
+
+    void evict_to(size_t capacity);
+  };
+
+  std::array<Shard, NUM_SHARDS> shards;
+
+  std::atomic<size_t> total_capacity{DEFAULT_CAPACITY};
+  std::atomic<uint64_t> hit_count{0};
+  std::atomic<uint64_t> miss_count{0};
+
+  Shard &shard_for(const Key &key);
+  size_t shard_capacity() const { return total_capacity.load() / NUM_SHARDS; }
+};
+
+} // namespace intellekt::duckpst::pst
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "pstsdk/util/primitives.h"
+#include "pstsdk/util/util.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace intellekt::duckpst::pst {
+
+// dwCRCPartial of the file header (changes whenever the header does)
+static constexpr uint64_t HEADER_CRC_OFFSET = 4;
+
+// wVer of the file header: ANSI files are 14/15, Unicode files 23 or later
+static constexpr uint64_t HEADER_VERSION_OFFSET = 10;
+static constexpr uint16_t HEADER_UNICODE_MIN_VERSION = 23;
+
+/**
+ * @brief A BBT block of a PST file, as given by pstsdk's block_info
+ */
+struct BlockRange {
+  uint64_t address;
+
+  // Size of the block data, excluding its trailer and alignment
+  uint64_t size;
+};
+
+/**
+ * @brief A pstsdk file that can be told which blocks will be read next, so
+ * they can be fetched in one batch instead of one synchronous read at a time
+ */
+class block_file : public pstsdk::file {
+protected:
+  uint64_t file_size = 0;
+
+  // Modification time (epoch seconds, 0 if unknown) and header CRC, which
+  // with the size identify a version of the file
+  int64_t modified_time = 0;
+  uint32_t header_crc = 0;
+
+  // Set from the header's wVer when the file is opened
+  bool unicode = true;
+
+  /**
+   * @brief Size of a block on disk: its data plus the block trailer, aligned
+   * to 64 bytes (this is what pstsdk reads)
+   *
+   * @param data_size
+   * @return uint64_t
+   */
+  uint64_t disk_block_size(uint64_t data_size) const {
+    uint64_t trailer_size = unicode ? 16 : 12;
+    return (data_size + trailer_size + 63) & ~uint64_t(63);
+  }
+
+public:
+  /**
+   * @brief Size of the file in bytes
+   *
+   * @return uint64_t
+   */
+  uint64_t size() const { return file_size; }
+
+  int64_t modified() const { return modified_time; }
+  uint32_t crc() const { return header_crc; }
+
+  /**
+   * @brief Start fetching blocks ahead of pstsdk reading them, without
+   * waiting for them. Failures are ignored, as the read proper will report
+   * them.
+   *
+   * @param blocks
+   */
+  virtual void prefetch(const std::vector<BlockRange> &blocks) const = 0;
+};
+
+} // namespace intellekt::duckpst::pst
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "pst/named_props.hpp"
+#include "pst/typed_bag.hpp"
+
+#include "pstsdk/ltp/table.h"
+#include "pstsdk/pst/pst.h"
+#include "pstsdk/util/primitives.h"
+
+#include <algorithm>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace intellekt::duckpst::pst {
+
+/**
+ * @brief The folder contents tables a scan reads message rows from, opened
+ * once per folder. Their row matrix holds a set of columns for every message
+ * in the folder, so reading those doesn't open each message's node.
+ *
+ * A folder's table is only used if it has a column for every prop the scan
+ * reads, otherwise its messages are read from their nodes.
+ */
+class ContentsTables {
+  // Tables by folder NID (empty if the folder's messages are read from nodes)
+  std::unordered_map<pstsdk::node_id, std::optional<pstsdk::table>> folders;
+  std::vector<pstsdk::prop_id> props;
+
+  // Rows of the file's messages, if planning recorded them
+  std::shared_ptr<const ContentsRows> rows;
+
+  std::optional<pstsdk::table> open(const pstsdk::pst &pst,
+                                    pstsdk::node_id folder_id) const {
+    try {
+      auto contents_id = pstsdk::make_nid(pstsdk::nid_type_contents_table,
+                                          pstsdk::get_nid_index(folder_id));
+      pstsdk::table contents(pst.get_db()->lookup_node(contents_id));
+
+      auto columns = contents.get_prop_list();
+      for (auto prop : props) {
+        if (std::find(columns.begin(), columns.end(), prop) == columns.end())
+          return {};
+      }
+
+      return contents;
+    } catch (std::exception &) {
+      return {};
+    }
+  }
+
+public:
+  /**
+   * @brief Forget the tables of the previous file, and set the props rows
+   * are read for (named props resolved against the new file)
+   *
+   * @param read_props
+   * @param file_rows Where the file's messages are in their tables, if known
+   */
+  void reset(std::vector<pstsdk::prop_id> &&read_props,
+             std::shared_ptr<const ContentsRows> file_rows = nullptr) {
+    folders.clear();
+    props = std::move(read_props);
+    rows = std::move(file_rows);
+
+    // No message has these, so the table doesn't need a column for them
+    props.erase(std::remove(props.begin(), props.end(),
+                            NamedPropCache::UNMAPPED),
+                props.end());
+  }
+
+  /**
+   * @brief Get a message's row of its folder's contents table. Rows recorded
+   * by planning are read directly, others are looked up through the NBT and
+   * the table's row index.
+   *
+   * @param pst
+   * @param nid Message NID
+   * @param folder_id Set to the folder of the table
+   * @return std::optional<pstsdk::const_table_row> Empty if the message has
+   * to be read from its node (e.g. it's an orphan, or associated content)
+   */
+  std::optional<pstsdk::const_table_row> lookup(const pstsdk::pst &pst,
+                                                pstsdk::node_id nid,
+                                                pstsdk::node_id &folder_id) {
+    try {
+      std::optional<pstsdk::ulong> row;
+      auto location = rows ? rows->find(nid) : ContentsRows::const_iterator();
+      if (rows && location != rows->end()) {
+        folder_id = location->second.folder;
+        row = location->second.row;
+      } else {
+        folder_id = pst.get_db()->lookup_node_info(nid).parent_id;
+      }
+
+      auto [folder, inserted] = folders.try_emplace(folder_id);
+      if (inserted)
+        folder->second = open(pst, folder_id);
+
+      if (!folder->second)
+        return {};
+
+      auto &contents = *folder->second;
+      return contents[row ? *row : contents.lookup_row(nid)];
+    } catch (std::exception &) {
+      return {};
+    }
+  }
+};
+
+} // namespace intellekt::duckpst::pst
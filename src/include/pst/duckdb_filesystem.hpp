@@ -3,17 +3,107 @@
 #include "duckdb/common/file_system.hpp"
 #include "duckdb/common/open_file_info.hpp"
 #include "duckdb/main/client_context.hpp"
+#include "pst/block_file.hpp"
 #include "pstsdk/util/primitives.h"
 #include "pstsdk/util/util.h"
 
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
 namespace intellekt::duckpst::pst {
 
+static constexpr uint64_t DEFAULT_READAHEAD_SIZE = 1024 * 1024;
+static constexpr uint64_t DEFAULT_READ_GAP_THRESHOLD = 16 * 1024;
+
 /**
  * @brief pstsdk file implementation for duckdb::FileHandle
+ *
+ * pstsdk requests one (small) block at a time, which makes scans of remote
+ * files latency bound. Reads are therefore coalesced: once a thread reads
+ * forward (allowing gaps of up to the gap threshold), it reads ahead into a
+ * window that grows with every further sequential read.
+ *
+ * Prefetched blocks are read by a small pool of I/O threads with file handles
+ * of their own, so readers keep decoding while the blocks arrive.
  */
-class dfile : public pstsdk::file {
+class dfile : public block_file {
+  duckdb::FileSystem &fs;
+  duckdb::OpenFileInfo file_info;
   duckdb::unique_ptr<duckdb::FileHandle> file_handle;
 
+  // Identity of this file (path, size and modification time) in the shared
+  // BlockCache
+  uint64_t cache_file_id;
+
+  uint64_t readahead_size;
+  uint64_t gap_threshold;
+
+  /**
+   * @brief Access pattern and readahead buffer of a reader thread (a dfile
+   * may be shared by the pstsdk::pst copies of several threads)
+   */
+  struct ReadStream {
+    uint64_t last_end = 0;
+    uint64_t sequential_reads = 0;
+    uint64_t next_readahead = 0;
+
+    uint64_t window_offset = 0;
+    std::vector<pstsdk::byte> window;
+
+    // Value of stream_uses when the thread last read
+    uint64_t last_used = 0;
+  };
+
+  mutable std::mutex streams_lock;
+  mutable std::unordered_map<std::thread::id, ReadStream> streams;
+  mutable uint64_t stream_uses = 0;
+
+  /**
+   * @brief The calling thread's stream (streams_lock must be held). The
+   * number of streams is bounded, evicting the least recently used.
+   *
+   * @return ReadStream&
+   */
+  ReadStream &this_stream() const;
+
+  // NBT and BBT root pages, read when the file is opened
+  std::map<uint64_t, std::vector<pstsdk::byte>> root_pages;
+
+  /**
+   * @brief Read the file header, and the NBT and BBT root pages it
+   * references, as pstsdk reads these first when mounting the file
+   */
+  void prefetch_root_pages();
+
+  void read_through(std::vector<pstsdk::byte> &buffer, uint64_t offset) const;
+
+  /**
+   * @brief Nearby blocks to prefetch in one read, [begin, end)
+   */
+  struct PrefetchRun {
+    uint64_t begin;
+    uint64_t end;
+    std::vector<std::pair<uint64_t, uint64_t>> blocks;
+  };
+
+  mutable std::mutex prefetch_lock;
+  mutable std::condition_variable prefetch_ready;
+  mutable std::deque<PrefetchRun> prefetch_runs;
+  mutable std::vector<std::thread> prefetch_threads;
+  mutable bool prefetch_stopping = false;
+
+  /**
+   * @brief Read queued runs into the BlockCache until the file is closed
+   * (runs on each I/O thread)
+   */
+  void prefetch_queued_runs() const;
+
 public:
   /**
    * @brief Construct a new "dfile"
@@ -22,16 +112,25 @@ public:
    * @param file DuckDB file info
    */
   dfile(duckdb::ClientContext &ctx, const duckdb::OpenFileInfo &file);
+  ~dfile() override;
 
   /**
    * @brief Construct a new shared "dfile"
    *
    * @param ctx
    * @param finfo
-   * @return std::shared_ptr<pstsdk::file>
+   * @return std::shared_ptr<block_file>
+   */
+  static std::shared_ptr<block_file> open(duckdb::ClientContext &ctx,
+                                          const duckdb::OpenFileInfo &finfo);
+
+  /**
+   * @brief Queue blocks to be read into the shared BlockCache (coalescing
+   * nearby blocks) by the I/O threads, without waiting for them
+   *
+   * @param blocks
    */
-  static std::shared_ptr<pstsdk::file> open(duckdb::ClientContext &ctx,
-                                            const duckdb::OpenFileInfo &finfo);
+  void prefetch(const std::vector<BlockRange> &blocks) const override;
 
   size_t read(std::vector<pstsdk::byte> &buffer,
               pstsdk::ulonglong offset) const override;
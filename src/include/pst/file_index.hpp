@@ -0,0 +1,73 @@
+#pragma once
+
+#include "pst/block_file.hpp"
+
+#include "duckdb/common/open_file_info.hpp"
+#include "duckdb/main/client_context.hpp"
+#include "pstsdk/pst.h"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace intellekt::duckpst::pst {
+
+/**
+ * @brief Sidecar index of a PST file: its folder and message NIDs, and the
+ * message class of every message, so planning doesn't have to crawl the NBT
+ * (and open every message) again.
+ *
+ * Indexes are written next to the file (`<file>.pstidx`), or into
+ * `pst_index_directory` if set, and are only used while the file's path
+ * (expanded and made absolute), size, modification time and header CRC match
+ * those recorded in the index.
+ */
+struct FileIndex {
+  std::vector<pstsdk::node_id> folders;
+  std::vector<pstsdk::node_id> messages;
+
+  // pst::MessageClass of each message
+  std::vector<uint8_t> message_classes;
+
+  /**
+   * @brief Is `pst_index_enabled` set?
+   *
+   * @param ctx
+   */
+  static bool enabled(duckdb::ClientContext &ctx);
+
+  /**
+   * @brief Load the index of a file, if there is one and it's current
+   *
+   * @param ctx
+   * @param file
+   * @param blocks The file, for its size, modification time and header CRC
+   * @return std::optional<FileIndex>
+   */
+  static std::optional<FileIndex> load(duckdb::ClientContext &ctx,
+                                       const duckdb::OpenFileInfo &file,
+                                       const block_file &blocks);
+
+  /**
+   * @brief Index a file by crawling its NBT (and reading message classes
+   * from its folders' contents tables)
+   *
+   * @param pst
+   * @return FileIndex
+   */
+  static FileIndex build(pstsdk::pst &pst);
+
+  /**
+   * @brief Write the index of a file. Failures (e.g. a read-only location)
+   * are logged and otherwise ignored.
+   *
+   * @param ctx
+   * @param file
+   * @param blocks
+   */
+  void save(duckdb::ClientContext &ctx, const duckdb::OpenFileInfo &file,
+            const block_file &blocks) const;
+};
+
+} // namespace intellekt::duckpst::pst
@@ -0,0 +1,82 @@
+#pragma once
+
+#ifndef _WIN32
+
+#include "pst/block_file.hpp"
+#include "pstsdk/util/primitives.h"
+#include "pstsdk/util/util.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace intellekt::duckpst::pst {
+
+/**
+ * @brief pstsdk file implementation for local files, serving reads straight
+ * from a read-only memory mapping (no syscall per block)
+ *
+ * The mapping is advised as random access, as NBT/BBT lookups jump around the
+ * file. When a run of forward reads (e.g. a body or attachment data tree) is
+ * detected, the pages ahead of it are advised as needed instead.
+ *
+ * A file truncated by another process while it is mapped raises SIGBUS on
+ * the next read past its new end, which can't be recovered from. Files that
+ * may be rewritten during a query should be read with pst_mmap disabled.
+ */
+class mfile : public block_file {
+  // The mapping outlives its file descriptor, so mapped files don't count
+  // against the process' open file limit
+  pstsdk::byte *data;
+
+  uint64_t readahead_size;
+  uint64_t gap_threshold;
+
+  // Shared by all readers of the mapping, so races only cost a stray hint
+  mutable std::atomic<uint64_t> last_end{0};
+  mutable std::atomic<uint64_t> advised_end{0};
+
+  void advise_sequential(uint64_t offset) const;
+
+public:
+  mfile(pstsdk::byte *data, uint64_t mapped_size, int64_t modified,
+        uint64_t readahead_size, uint64_t gap_threshold);
+  ~mfile();
+
+  mfile(const mfile &) = delete;
+  mfile &operator=(const mfile &) = delete;
+
+  /**
+   * @brief Map a local file, which the DuckDB file system has already opened
+   * (so its access checks apply)
+   *
+   * @param path Local (expanded) file path
+   * @param expected_size Size of the file as opened by DuckDB; the file isn't
+   * mapped if its size changed since
+   * @param readahead_size Bytes to advise ahead of sequential reads
+   * @param gap_threshold Largest gap between reads to count as sequential
+   * @return std::shared_ptr<block_file> nullptr if the file can't be mapped
+   */
+  static std::shared_ptr<block_file> open(const std::string &path,
+                                          uint64_t expected_size,
+                                          uint64_t readahead_size,
+                                          uint64_t gap_threshold);
+
+  /**
+   * @brief Advise the pages of blocks as needed, so the kernel reads them in
+   * the background
+   *
+   * @param blocks
+   */
+  void prefetch(const std::vector<BlockRange> &blocks) const override;
+
+  size_t read(std::vector<pstsdk::byte> &buffer,
+              pstsdk::ulonglong offset) const override;
+  size_t write(const std::vector<pstsdk::byte> &buffer,
+               pstsdk::ulonglong offset) override;
+};
+} // namespace intellekt::duckpst::pst
+
+#endif
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "pstsdk/pst/pst.h"
+#include "pstsdk/util/primitives.h"
+
+#include <array>
+#include <cstring>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <utility>
+
+namespace intellekt::duckpst::pst {
+
+/**
+ * @brief Named property (PSETID + LID) to prop ID mappings of a single PST
+ * file. The mapping is constant for a file, so each name is resolved once and
+ * then shared by every thread reading that file.
+ */
+class NamedPropCache {
+  using key_type =
+      std::pair<std::array<pstsdk::byte, sizeof(pstsdk::guid)>, long>;
+
+  std::mutex lock;
+  std::map<key_type, pstsdk::prop_id> props;
+
+public:
+  // Named props missing from the file's name-to-id map resolve to this, which
+  // never exists on a prop bag
+  static constexpr pstsdk::prop_id UNMAPPED = 0;
+
+  /**
+   * @brief Get the prop ID of a named property, resolving it against the file
+   * on first use
+   *
+   * @param pst The caller's (thread-local) handle on the file
+   * @param named_set Property set GUID
+   * @param named_id Property LID
+   * @return pstsdk::prop_id
+   */
+  pstsdk::prop_id resolve(pstsdk::pst &pst, const pstsdk::guid &named_set,
+                          long named_id) {
+    key_type key;
+    std::memcpy(key.first.data(), &named_set, sizeof(pstsdk::guid));
+    key.second = named_id;
+
+    std::lock_guard<std::mutex> guard(lock);
+
+    auto maybe_prop = props.find(key);
+    if (maybe_prop != props.end())
+      return maybe_prop->second;
+
+    pstsdk::prop_id prop = UNMAPPED;
+    try {
+      prop = pst.lookup_prop_id(named_set, named_id);
+    } catch (std::exception &) {
+      // Not in the name-to-id map, so no item in this file can have it
+    }
+
+    props.emplace(key, prop);
+    return prop;
+  }
+};
+
+} // namespace intellekt::duckpst::pst
@@ -1,10 +1,20 @@
 #pragma once
 
 #include "pstsdk/ltp/propbag.h"
+#include "pstsdk/ltp/table.h"
 #include "pstsdk/mapitags.h"
 #include "pstsdk/pst/pst.h"
+#include <algorithm>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <set>
+#include <string>
 #include <type_traits>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 namespace intellekt::duckpst::pst {
 
@@ -81,6 +91,35 @@ inline MessageClass container_class(const pstsdk::pst &pst,
   return klass;
 }
 
+/**
+ * @brief Get the message class of a PR_MESSAGE_CLASS value
+ *
+ * @param name
+ * @return MessageClass
+ */
+inline MessageClass message_class(const std::string &name) {
+  auto maybe_klass = MESSAGE_CLASS_MAP.find(name);
+  if (maybe_klass != MESSAGE_CLASS_MAP.end()) {
+    auto &[_name, klass] = *maybe_klass;
+    return klass;
+  }
+
+  return BASE_CLASS;
+}
+
+/**
+ * @brief Read a message's PR_MESSAGE_CLASS_A off its node
+ *
+ * @param pst
+ * @param nid
+ * @return std::optional<std::string> Empty if the message has no class
+ */
+inline std::optional<std::string>
+read_message_class(const pstsdk::pst &pst, const pstsdk::node_id &nid) {
+  auto bag = pstsdk::property_bag(pst.get_db().get()->lookup_node(nid));
+  return bag.read_prop_if_exists<std::string>(PR_MESSAGE_CLASS_A);
+}
+
 /**
  * @brief Get the container class of a message by reading PR_MESSAGE_CLASS_A
  *
@@ -89,40 +128,250 @@ inline MessageClass container_class(const pstsdk::pst &pst,
  */
 inline MessageClass message_class(const pstsdk::pst &pst,
                                   const pstsdk::node_id &nid) {
-  auto bag = pstsdk::property_bag(pst.get_db().get()->lookup_node(nid));
-  auto maybe_msg_class =
-      bag.read_prop_if_exists<std::string>(PR_MESSAGE_CLASS_A);
+  auto maybe_msg_class = read_message_class(pst, nid);
 
-  auto klass = BASE_CLASS;
+  if (maybe_msg_class)
+    return message_class(*maybe_msg_class);
 
-  if (maybe_msg_class) {
-    auto maybe_klass = MESSAGE_CLASS_MAP.find(*maybe_msg_class);
-    if (maybe_klass != MESSAGE_CLASS_MAP.end()) {
-      auto &[_name, k] = *maybe_klass;
-      klass = k;
+  return BASE_CLASS;
+}
+
+/**
+ * @brief Position of a message's row in its folder's contents table
+ */
+struct ContentsRow {
+  pstsdk::node_id folder;
+  pstsdk::ulong row;
+};
+
+using ContentsRows = std::unordered_map<pstsdk::node_id, ContentsRow>;
+
+using NodeIds = std::unordered_set<pstsdk::node_id>;
+
+/**
+ * @brief Checks a message's row of its folder's contents table against a
+ * predicate: false rules the message out, true rules it in, and no answer
+ * (e.g. the row lacks the cells) leaves the message to be checked by its node
+ */
+using RowCheck = std::function<std::optional<bool>(pstsdk::const_table_row &)>;
+
+/**
+ * @brief Classifies messages from the PR_MESSAGE_CLASS column of every
+ * folder's contents table, read once up front, so planning doesn't open each
+ * message node. Messages missing from the contents tables (orphans,
+ * associated contents), or without a class cell in them, are classified by
+ * reading their node.
+ */
+class MessageClassifier {
+  const pstsdk::pst &pst;
+
+  // PR_MESSAGE_CLASS of each message with a class cell in its contents table
+  std::unordered_map<pstsdk::node_id, std::string> classes;
+
+  // Where each message's row is, if asked for
+  std::shared_ptr<ContentsRows> rows;
+
+  // NIDs of the rows read, in ascending order
+  std::vector<pstsdk::node_id> row_ids;
+
+  // Messages whose rows the check ruled out (left out of row_ids) or in
+  RowCheck check;
+  NodeIds rejected;
+  std::shared_ptr<NodeIds> accepted;
+
+  void read_contents(const pstsdk::table &contents, pstsdk::node_id folder) {
+    // Rows without a class cell (or tables without the column) say nothing
+    // about the message, so its node is read instead
+    for (pstsdk::ulong row = 0; row < contents.size(); ++row) {
+      auto message = contents[row];
+      auto nid = message.get_row_id();
+      if (check) {
+        auto passed = check(message);
+        if (passed && !*passed) {
+          rejected.insert(nid);
+          continue;
+        }
+        if (passed)
+          accepted->insert(nid);
+      }
+
+      row_ids.push_back(nid);
+      if (rows)
+        rows->emplace(nid, ContentsRow{folder, row});
+      if (message.prop_exists(PR_MESSAGE_CLASS_A))
+        classes.emplace(nid,
+                        message.read_prop<std::string>(PR_MESSAGE_CLASS_A));
     }
   }
 
-  return klass;
-}
+  void sort_row_ids() {
+    std::sort(row_ids.begin(), row_ids.end());
+    row_ids.erase(std::unique(row_ids.begin(), row_ids.end()), row_ids.end());
+  }
+
+public:
+  /**
+   * @brief Read the contents tables of a file
+   *
+   * @param pst
+   * @param locate Also record where each message's row is (see
+   * contents_rows)
+   * @param check Checked against every row (see rejects and accepted_rows)
+   */
+  explicit MessageClassifier(const pstsdk::pst &pst, bool locate = false,
+                             RowCheck check = {})
+      : pst(pst), check(std::move(check)) {
+    if (locate)
+      rows = std::make_shared<ContentsRows>();
+    if (this->check)
+      accepted = std::make_shared<NodeIds>();
+
+    for (auto it = pst.folder_begin(); it != pst.folder_end(); ++it) {
+      try {
+        auto folder = *it;
+        read_contents(folder.get_contents_table(), folder.get_id());
+      } catch (std::exception &) {
+        // The folder's messages are classified one by one instead
+      }
+    }
+    sort_row_ids();
+  }
+
+  /**
+   * @brief Read the contents tables of some folders only. NIDs that aren't
+   * folders of the file are skipped, but a table that can't be read throws.
+   *
+   * @param pst
+   * @param folders
+   * @param locate See above
+   * @param check See above
+   */
+  MessageClassifier(const pstsdk::pst &pst,
+                    const std::set<pstsdk::node_id> &folders, bool locate,
+                    RowCheck check = {})
+      : pst(pst), check(std::move(check)) {
+    if (locate)
+      rows = std::make_shared<ContentsRows>();
+    if (this->check)
+      accepted = std::make_shared<NodeIds>();
+
+    auto db = pst.get_db();
+    for (auto folder : folders) {
+      if (pstsdk::get_nid_type(folder) != pstsdk::nid_type_folder)
+        continue;
+
+      try {
+        db->lookup_node_info(folder);
+      } catch (std::exception &) {
+        // Not in this file
+        continue;
+      }
+
+      auto contents_id = pstsdk::make_nid(pstsdk::nid_type_contents_table,
+                                          pstsdk::get_nid_index(folder));
+      read_contents(pstsdk::table(db->lookup_node(contents_id)), folder);
+    }
+    sort_row_ids();
+  }
+
+  /**
+   * @brief NIDs of the messages with a row in the tables read (that the
+   * check didn't rule out), ascending
+   *
+   * @return const std::vector<pstsdk::node_id>&
+   */
+  const std::vector<pstsdk::node_id> &messages() const { return row_ids; }
+
+  /**
+   * @brief Where each message's row is in its folder's contents table (NULL
+   * unless asked for), so scans of the rows don't have to look them up
+   *
+   * @return std::shared_ptr<const ContentsRows>
+   */
+  std::shared_ptr<const ContentsRows> contents_rows() const { return rows; }
+
+  /**
+   * @brief Did the check rule a message out by its row?
+   *
+   * @param nid
+   */
+  bool rejects(const pstsdk::node_id &nid) const {
+    return rejected.count(nid) > 0;
+  }
+
+  /**
+   * @brief Messages the check ruled in by their rows (NULL without a check),
+   * so scans don't have to check their nodes again
+   *
+   * @return std::shared_ptr<const NodeIds>
+   */
+  std::shared_ptr<const NodeIds> accepted_rows() const { return accepted; }
+
+  /**
+   * @brief Get the PR_MESSAGE_CLASS of a message (e.g. for classes that
+   * aren't a MessageClass, like meeting requests or reports)
+   *
+   * @param nid
+   * @return std::optional<std::string>
+   */
+  std::optional<std::string> name(const pstsdk::node_id &nid) const {
+    auto maybe_klass = classes.find(nid);
+    if (maybe_klass != classes.end())
+      return maybe_klass->second;
+
+    return read_message_class(pst, nid);
+  }
+
+  MessageClass operator()(const pstsdk::node_id &nid) const {
+    auto klass = name(nid);
+    if (klass)
+      return message_class(*klass);
+
+    return BASE_CLASS;
+  }
+};
 
 /**
  * @brief A typed wrapper for pstsdk prop bags, allowing them to be mounted
- *directly from NID, where the pstsdk companion object is instantiated alongside
+ *directly from NID, where the pstsdk companion object is instantiated lazily
  *
  * @tparam V The message/container class type
  * @tparam T The SDK companion object
  */
 template <MessageClass V, typename T = pstsdk::message> struct TypedBag {
+  static constexpr MessageClass klass = V;
+
   pstsdk::node_id nid;
   pstsdk::pst &pst;
-  pstsdk::node node;
-  pstsdk::property_bag bag;
 
-  std::optional<T> sdk_object;
+  // Props are read from either the node's own prop bag, or the message's row
+  // of its folder's contents table (which doesn't read the node's blocks)
+  std::optional<pstsdk::property_bag> node_bag;
+  std::optional<pstsdk::const_table_row> contents_row;
+
+  // Folder of the contents table the row is from
+  pstsdk::node_id contents_folder = 0;
+
+  std::optional<pstsdk::node> node_handle;
+  std::optional<T> companion;
+
+  /**
+   * @brief Mount an item from its node, or from its row of a folder's
+   * contents table, in which case the node is only looked up if needed
+   *
+   * @param pst
+   * @param nid
+   * @param contents_row
+   * @param contents_folder The folder whose contents table the row is from
+   */
+  inline TypedBag(pstsdk::pst &pst, pstsdk::node_id nid,
+                  std::optional<pstsdk::const_table_row> &&contents_row = {},
+                  pstsdk::node_id contents_folder = 0)
+      : nid(nid), pst(pst), contents_row(std::move(contents_row)),
+        contents_folder(contents_folder) {
+    if (!this->contents_row)
+      node_bag.emplace(node());
 
-  inline TypedBag(pstsdk::pst &pst, pstsdk::node_id nid)
-      : nid(nid), pst(pst), node(pst.get_db()->lookup_node(nid)), bag(node) {
 #ifdef DUCKPST_TYPED_BAG_CHECK_STRICT
     auto message_class =
         message.get_property_bag().read_prop_if_exists<std::string>(
@@ -141,11 +390,58 @@ template <MessageClass V, typename T = pstsdk::message> struct TypedBag {
       throw duckdb::InvalidInputException(
           "TypedBag instantiated as %s, but is %s", templ_name, *message_class);
 #endif
-    if constexpr (std::is_same_v<T, pstsdk::folder>) {
-      sdk_object.emplace(pstsdk::folder(pst.get_db(), node));
-    } else {
-      sdk_object.emplace(pstsdk::message(node));
+  }
+
+  /**
+   * @brief Get the pstsdk companion object, constructing it on first use. It
+   * reads the node's prop bag again and sets up its subnode tables, which plain
+   * prop columns never need
+   *
+   * @return T&
+   */
+  inline T &sdk_object() {
+    if (!companion) {
+      if constexpr (std::is_same_v<T, pstsdk::folder>) {
+        companion.emplace(pstsdk::folder(pst.get_db(), node()));
+      } else {
+        companion.emplace(pstsdk::message(node()));
+      }
     }
+    return *companion;
+  }
+
+  /**
+   * @brief Get the item's node, looking it up on first use
+   *
+   * @return pstsdk::node&
+   */
+  inline pstsdk::node &node() {
+    if (!node_handle)
+      node_handle.emplace(pst.get_db()->lookup_node(nid));
+    return *node_handle;
+  }
+
+  /**
+   * @brief Get the NID of the item's parent (for contents table rows, the
+   * folder of the table, without looking up the node)
+   *
+   * @return pstsdk::node_id
+   */
+  inline pstsdk::node_id parent_id() {
+    if (contents_row)
+      return contents_folder;
+    return node().get_parent_id();
+  }
+
+  /**
+   * @brief Get the props of the item
+   *
+   * @return pstsdk::const_property_object&
+   */
+  inline pstsdk::const_property_object &bag() {
+    if (contents_row)
+      return *contents_row;
+    return *node_bag;
   }
 
   inline MessageClass message_class() { return V; }
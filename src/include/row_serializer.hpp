@@ -1,5 +1,6 @@
 #pragma once
 
+#include "column_plan.hpp"
 #include "function_state.hpp"
 #include "duckdb/common/types.hpp"
 #include "duckdb/common/types/data_chunk.hpp"
@@ -8,83 +9,80 @@
 #include "pstsdk/util/primitives.h"
 
 /**
- * @brief Obtain duckdb::Value from pstsdk objects
+ * @brief Serialize pstsdk objects into DuckDB output vectors
  *
  */
 namespace intellekt::duckpst::row_serializer {
 
 /**
- * @brief Given a prop ID (against its CXX runtime type), make a DuckDB value.
+ * @brief Given a prop ID (against its CXX runtime type), write it directly into
+ * an output vector (NULL if the prop does not exist).
  *
  * @tparam T e.g., idx_t, or std::string, or std::wstring
- * @param t The logical type of the target column
+ * @param vec Target (flat) output vector, its logical type drives conversion
+ * @param row Row number
  * @param bag A pstsdk prop bag
  * @param prop A MAPI property ID
- * @return duckdb::Value
  */
 template <typename T>
-duckdb::Value from_prop(const LogicalType &t,
-                        pstsdk::const_property_object &bag,
-                        pstsdk::prop_id prop);
+void write_prop(duckdb::Vector &vec, idx_t row,
+                pstsdk::const_property_object &bag, pstsdk::prop_id prop);
 
 /**
- * @brief Same as from_prop, but against a stream reader with a specified read
+ * @brief Same as write_prop, but against a stream reader with a specified read
  * size.
  *
- * @tparam T e.g., idx_t, or std::string, or std::wstring
- * @param t The logical type of the target column
+ * @tparam T e.g., std::string, or vector<pstsdk::byte>
+ * @param vec Target (flat) output vector
+ * @param row Row number
  * @param bag A pstsdk prop bag
  * @param prop A MAPI property ID
- * @param read_size_bytes How many bytes to read
- * @return duckdb::Value
+ * @param read_size_bytes Max bytes to read (0 reads the whole prop)
  */
 template <typename T>
-duckdb::Value from_prop_stream(const LogicalType &t,
-                               pstsdk::const_property_object &bag,
-                               pstsdk::prop_id prop, idx_t read_size_bytes);
+void write_prop_stream(duckdb::Vector &vec, idx_t row,
+                       pstsdk::const_property_object &bag, pstsdk::prop_id prop,
+                       idx_t read_size_bytes);
 
 /**
- * @brief Set an output column for the current row
+ * @brief Resolve a reader for every projected column. This is done once per
+ * scan, so the per-row loop only has to call through the plan
  *
- * @tparam Item A pstsdk type (either message, or folder, or
- * const_property_object)
- * @param local_state Local read state
- * @param output Target data chunk
- * @param item pstsdk object being read
- * @param row_number Row number
- * @param column_index Column index (use column_ids to resolve against schema)
+ * @tparam Item A TypedBag variant
+ * @param column_indexes Projected columns (against the table function schema),
+ * including any STRUCT fields pushed down
+ * @return ColumnPlan<Item>
  */
 template <typename Item>
-void set_output_column(PSTReadLocalState &local_state,
-                       duckdb::DataChunk &output, Item &item, idx_t row_number,
-                       idx_t column_index);
+ColumnPlan<Item> plan_columns(const vector<ColumnIndex> &column_indexes);
 
 /**
  * @brief Append a row to the output chunk
  *
- * @tparam Item A pstsdk type (either message, or folder, or
- * const_property_object)
+ * @tparam Item A TypedBag variant
  * @param local_state Local read state
+ * @param plan Column readers from plan_columns
  * @param output Target data chunk
  * @param item pstsdk object being read
  * @param row_number Row number
  */
 template <typename Item>
-void into_row(PSTReadLocalState &local_state, duckdb::DataChunk &output,
-              Item &item, idx_t row_number);
+void into_row(PSTReadLocalState &local_state, const ColumnPlan<Item> &plan,
+              duckdb::DataChunk &output, Item &item, idx_t row_number);
 
 /**
- * @brief Make a struct value from a pstsdk item
+ * @brief Write a pstsdk item into a row of a STRUCT vector
  *
- * @tparam Item A pstsdk type (either message, or folder, or
- * const_property_object)
+ * @tparam Item A pstsdk type (either recipient, or attachment)
  * @param local_state Local read state
- * @param t Struct schema
+ * @param fields Projected struct fields (empty reads all of them), the others
+ * are set to NULL
  * @param item pstsdk object being read
- * @return duckdb::Value
+ * @param target STRUCT vector (e.g., the child of a LIST column)
+ * @param row_number Row number
  */
 template <typename Item>
-duckdb::Value into_struct(PSTReadLocalState &local_state, const LogicalType &t,
-                          Item item);
+void into_struct(PSTReadLocalState &local_state, const vector<idx_t> &fields,
+                 Item item, duckdb::Vector &target, idx_t row_number);
 
 } // namespace intellekt::duckpst::row_serializer
@@ -0,0 +1,134 @@
+#pragma once
+
+#include "duckdb/common/types/value.hpp"
+#include "duckdb/planner/expression.hpp"
+#include "duckdb/planner/operator/logical_get.hpp"
+#include "pstsdk/ltp/object.h"
+#include "pstsdk/util/primitives.h"
+
+#include <cstdint>
+#include <optional>
+#include <set>
+#include <string>
+
+namespace intellekt::duckpst {
+using namespace duckdb;
+
+/**
+ * @brief A range filter on a timestamp column, checked against the FILETIME
+ * prop it's read from
+ */
+struct PSTTimeRange {
+  pstsdk::prop_id prop;
+
+  // Inclusive bounds (epoch microseconds)
+  int64_t min;
+  int64_t max;
+};
+
+/**
+ * @brief Predicates on the identity columns of a PST read (node_id,
+ * parent_node_id, pst_path) and on message_class, pushed down from the query
+ * so planning only partitions the nodes (and files) that can match. Range
+ * predicates on timestamp columns are checked against the contents tables
+ * while planning messages (for the columns the tables hold), and by the scan
+ * before the rest of a row is read.
+ *
+ * The filters are still applied to the output (as table filters), so these
+ * only ever narrow the read to a superset of the matching rows.
+ */
+struct PSTScanFilters {
+  // node_id = x, or node_id IN (...): planned as direct NBT lookups
+  std::optional<std::set<pstsdk::node_id>> node_ids;
+
+  // parent_node_id = x, or IN (...): only the children of these folders
+  std::optional<std::set<pstsdk::node_id>> parent_node_ids;
+
+  // pst_path = x, or IN (...): other files aren't planned at all
+  std::optional<std::set<std::string>> pst_paths;
+
+  // message_class = x, or IN (...): only messages of these classes
+  std::optional<std::set<std::string>> message_classes;
+
+  // message_class LIKE 'x%' (or starts_with): only classes with all of these
+  // prefixes
+  vector<std::string> message_class_prefixes;
+
+  // message_delivery_time (etc.) BETWEEN, <, >, or = constants
+  vector<PSTTimeRange> time_ranges;
+
+  bool empty() const { return !narrows_planning(); }
+
+  bool narrows_planning() const {
+    return node_ids || parent_node_ids || pst_paths || filters_classes() ||
+           !time_ranges.empty();
+  }
+
+  bool filters_classes() const {
+    return message_classes || !message_class_prefixes.empty();
+  }
+
+  bool matches_parent(pstsdk::node_id parent_id) const {
+    return !parent_node_ids || parent_node_ids->count(parent_id) > 0;
+  }
+
+  bool matches_path(const std::string &path) const {
+    return !pst_paths || pst_paths->count(path) > 0;
+  }
+
+  /**
+   * @brief Does a message's PR_MESSAGE_CLASS pass the class filters? (a
+   * message without one never does, as its message_class is NULL)
+   *
+   * @param klass
+   */
+  bool matches_class(const std::optional<std::string> &klass) const {
+    if (!filters_classes())
+      return true;
+    if (!klass || (message_classes && !message_classes->count(*klass)))
+      return false;
+
+    for (auto &prefix : message_class_prefixes) {
+      if (klass->compare(0, prefix.size(), prefix) != 0)
+        return false;
+    }
+    return true;
+  }
+
+  /**
+   * @brief Is a message (given its props) within every time range? Only
+   * reads the timestamp props.
+   *
+   * @param bag
+   */
+  bool matches_times(pstsdk::const_property_object &bag) const;
+
+  /**
+   * @brief Is a message within every time range, given its row of a contents
+   * table? Only PR_MESSAGE_DELIVERY_TIME and PR_LAST_MODIFICATION_TIME have
+   * columns there, so there's no answer for other ranges, or for rows
+   * without a cell.
+   *
+   * @param row
+   * @return std::optional<bool>
+   */
+  std::optional<bool>
+  row_matches_times(pstsdk::const_property_object &row) const;
+
+  /**
+   * @brief Collect a filter expression (of the table function's LogicalGet)
+   * if it's an equality or IN predicate on an identity column, or an
+   * equality, IN or prefix predicate on message_class, or a range predicate
+   * on a timestamp column. Anything else is left to DuckDB.
+   *
+   * @param get
+   * @param filter
+   * @param messages Is this a message read? (folders have no message_class)
+   */
+  void collect(const LogicalGet &get, const Expression &filter, bool messages);
+
+private:
+  void restrict_time(pstsdk::prop_id prop, int64_t min, int64_t max);
+};
+
+} // namespace intellekt::duckpst
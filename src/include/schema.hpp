@@ -76,8 +76,18 @@ inline const auto ATTACH_METHOD_ENUM = AttachMethodSchema();
 // We'll generate our table function output schemas using x-macros so the
 // serialization code doesn't have to bind against a position ordinal and we can
 // move columns around
-#define SCHEMA_CHILD(name, type) {#name, type},
+//
+// Table function columns are LT(name, type, source), where source says where
+// the value comes from and how it's converted (see column_plan.hpp):
+//   BAG_PROP(T, prop)                  A MAPI prop on the item's prop bag
+//   STORE_PROP(T, prop)                A MAPI prop on the PST message store
+//   NAMED_PROP(T, guid, lid)           A named prop on the item's prop bag
+//   COMPUTED(reader)                   Computed by a reader function
+//   COMPUTED_PROP(reader, prop)        Same, against a MAPI prop
+//   COMPUTED_NAMED_PROP(reader, guid, lid) Same, against a named prop
+#define SCHEMA_CHILD(name, type, source) {#name, type},
 #define SCHEMA_CHILD_NAME(name, ...) name,
+#define STRUCT_CHILD(name, type) {#name, type},
 
 /* Recipient struct schema */
 
@@ -92,7 +102,7 @@ inline const auto ATTACH_METHOD_ENUM = AttachMethodSchema();
 enum class RecipientProjection { RECIPIENT_CHILDREN(SCHEMA_CHILD_NAME) };
 
 inline const auto RECIPIENT_SCHEMA =
-    LogicalType::STRUCT({RECIPIENT_CHILDREN(SCHEMA_CHILD)});
+    LogicalType::STRUCT({RECIPIENT_CHILDREN(STRUCT_CHILD)});
 
 /* Attachment struct schema */
 
@@ -108,7 +118,7 @@ inline const auto RECIPIENT_SCHEMA =
 enum class AttachmentProjection { ATTACHMENT_CHILDREN(SCHEMA_CHILD_NAME) };
 
 inline const auto ATTACHMENT_SCHEMA =
-    LogicalType::STRUCT({ATTACHMENT_CHILDREN(SCHEMA_CHILD)});
+    LogicalType::STRUCT({ATTACHMENT_CHILDREN(STRUCT_CHILD)});
 
 /* One-off recipient attributes */
 #define ONE_OFF_RECIPIENT_CHILDREN(LT)                                         \
@@ -117,16 +127,18 @@ inline const auto ATTACHMENT_SCHEMA =
   LT(email_address, LogicalType::VARCHAR)
 
 inline const auto ONE_OFF_RECIPIENT_SCHEMA =
-    LogicalType::STRUCT({ONE_OFF_RECIPIENT_CHILDREN(SCHEMA_CHILD)});
+    LogicalType::STRUCT({ONE_OFF_RECIPIENT_CHILDREN(STRUCT_CHILD)});
 
 /* Per-file PST attributes */
 
 #define PST_CHILDREN(LT)                                                       \
-  LT(pst_path, LogicalType::VARCHAR)                                           \
-  LT(pst_name, LogicalType::VARCHAR)                                           \
-  LT(record_key, LogicalType::BLOB)                                            \
-  LT(node_id, LogicalType::UINTEGER)                                           \
-  LT(parent_node_id, LogicalType::UINTEGER)
+  LT(pst_path, LogicalType::VARCHAR, COMPUTED(read_pst_path))                  \
+  LT(pst_name, LogicalType::VARCHAR,                                           \
+     STORE_PROP(std::string, PR_DISPLAY_NAME_A))                               \
+  LT(record_key, LogicalType::BLOB,                                            \
+     STORE_PROP(std::vector<pstsdk::byte>, PR_RECORD_KEY))                     \
+  LT(node_id, LogicalType::UINTEGER, COMPUTED(read_node_id))                   \
+  LT(parent_node_id, LogicalType::UINTEGER, COMPUTED(read_parent_node_id))
 
 enum class PSTProjection { PST_CHILDREN(SCHEMA_CHILD_NAME) };
 inline const auto PST_SCHEMA =
@@ -140,28 +152,40 @@ inline const auto PST_SCHEMA =
    * EntryID and NID) */                                                       \
   /* LT(entry_id, LogicalType::BLOB) */                                        \
   /* LT(parent_entry_id, LogicalType::BLOB) */                                 \
-  LT(subject, LogicalType::VARCHAR)                                            \
-  LT(body, LogicalType::VARCHAR)                                               \
-  LT(body_html, LogicalType::VARCHAR)                                          \
-  LT(display_name, LogicalType::VARCHAR)                                       \
-  LT(comment, LogicalType::VARCHAR)                                            \
-  LT(sender_name, LogicalType::VARCHAR)                                        \
-  LT(sender_email_address, LogicalType::VARCHAR)                               \
-  LT(recipients, LogicalType::LIST(RECIPIENT_SCHEMA))                          \
-  LT(has_attachments, LogicalType::BOOLEAN)                                    \
-  LT(attachment_count, LogicalType::UINTEGER)                                  \
-  LT(attachments, LogicalType::LIST(ATTACHMENT_SCHEMA))                        \
-  LT(importance, IMPORTANCE_ENUM)                                              \
-  LT(priority, PRIORITY_ENUM)                                                  \
-  LT(sensitivity, SENSITIVITY_ENUM)                                            \
-  LT(creation_time, LogicalType::TIMESTAMP_S)                                  \
-  LT(last_modified, LogicalType::TIMESTAMP_S)                                  \
-  LT(message_delivery_time, LogicalType::TIMESTAMP_S)                          \
-  LT(message_class, LogicalType::VARCHAR)                                      \
-  LT(message_flags, LogicalType::INTEGER)                                      \
-  LT(message_size, LogicalType::UBIGINT)                                       \
-  LT(conversation_topic, LogicalType::VARCHAR)                                 \
-  LT(internet_message_id, LogicalType::VARCHAR)
+  LT(subject, LogicalType::VARCHAR, BAG_PROP(std::string, PR_SUBJECT_A))       \
+  LT(body, LogicalType::VARCHAR, COMPUTED_PROP(read_body, PR_BODY_A))          \
+  LT(body_html, LogicalType::VARCHAR, COMPUTED_PROP(read_body, PR_HTML))       \
+  LT(display_name, LogicalType::VARCHAR,                                       \
+     BAG_PROP(std::string, PR_DISPLAY_NAME_A))                                 \
+  LT(comment, LogicalType::VARCHAR, BAG_PROP(std::string, PR_COMMENT_A))       \
+  LT(sender_name, LogicalType::VARCHAR,                                        \
+     BAG_PROP(std::string, PR_SENDER_NAME_A))                                  \
+  LT(sender_email_address, LogicalType::VARCHAR,                               \
+     BAG_PROP(std::string, PR_SENDER_EMAIL_ADDRESS_A))                         \
+  LT(recipients, LogicalType::LIST(RECIPIENT_SCHEMA),                          \
+     COMPUTED(read_recipients))                                                \
+  LT(has_attachments, LogicalType::BOOLEAN, COMPUTED(read_has_attachments))    \
+  LT(attachment_count, LogicalType::UINTEGER, COMPUTED(read_attachment_count)) \
+  LT(attachments, LogicalType::LIST(ATTACHMENT_SCHEMA),                        \
+     COMPUTED(read_attachments))                                               \
+  LT(importance, IMPORTANCE_ENUM, BAG_PROP(int32_t, PR_IMPORTANCE))            \
+  LT(priority, PRIORITY_ENUM, COMPUTED_PROP(read_priority, PR_PRIORITY))       \
+  LT(sensitivity, SENSITIVITY_ENUM, BAG_PROP(int32_t, PR_SENSITIVITY))         \
+  LT(creation_time, LogicalType::TIMESTAMP_S,                                  \
+     BAG_PROP(pstsdk::ulonglong, PR_CREATION_TIME))                            \
+  LT(last_modified, LogicalType::TIMESTAMP_S,                                  \
+     BAG_PROP(pstsdk::ulonglong, PR_LAST_MODIFICATION_TIME))                   \
+  LT(message_delivery_time, LogicalType::TIMESTAMP_S,                          \
+     BAG_PROP(pstsdk::ulonglong, PR_MESSAGE_DELIVERY_TIME))                    \
+  LT(message_class, LogicalType::VARCHAR,                                      \
+     BAG_PROP(std::string, PR_MESSAGE_CLASS_A))                                \
+  LT(message_flags, LogicalType::INTEGER, BAG_PROP(int32_t, PR_MESSAGE_FLAGS)) \
+  LT(message_size, LogicalType::UBIGINT,                                       \
+     COMPUTED_PROP(read_message_size, PR_MESSAGE_SIZE))                        \
+  LT(conversation_topic, LogicalType::VARCHAR,                                 \
+     BAG_PROP(std::string, PR_CONVERSATION_TOPIC_A))                           \
+  LT(internet_message_id, LogicalType::VARCHAR,                                \
+     BAG_PROP(std::string, PR_INTERNET_MESSAGE_ID))
 
 enum class NoteProjection {
   PST_CHILDREN(SCHEMA_CHILD_NAME) NOTE_CHILDREN(SCHEMA_CHILD_NAME)
@@ -173,83 +197,145 @@ inline const auto NOTE_SCHEMA = LogicalType::STRUCT(
 /* Contact schema */
 
 #define CONTACT_CHILDREN(LT)                                                   \
-  LT(display_name_prefix, LogicalType::VARCHAR)                                \
-  LT(given_name, LogicalType::VARCHAR)                                         \
-  LT(middle_name, LogicalType::VARCHAR)                                        \
-  LT(surname, LogicalType::VARCHAR)                                            \
-  LT(generation_suffix, LogicalType::VARCHAR)                                  \
-  LT(initials, LogicalType::VARCHAR)                                           \
-  LT(nickname, LogicalType::VARCHAR)                                           \
-  LT(preferred_by_name, LogicalType::VARCHAR)                                  \
-  LT(account_name, LogicalType::VARCHAR)                                       \
-  LT(original_display_name, LogicalType::VARCHAR)                              \
-  LT(transmittable_display_name, LogicalType::VARCHAR)                         \
-  LT(mhs_common_name, LogicalType::VARCHAR)                                    \
-  LT(government_id_number, LogicalType::VARCHAR)                               \
-  LT(organizational_id_number, LogicalType::VARCHAR)                           \
-  LT(birthday, LogicalType::TIMESTAMP_S)                                       \
-  LT(wedding_anniversary, LogicalType::TIMESTAMP_S)                            \
-  LT(spouse_name, LogicalType::VARCHAR)                                        \
-  LT(childrens_names, LogicalType::VARCHAR)                                    \
-  LT(gender, LogicalType::SMALLINT)                                            \
-  LT(hobbies, LogicalType::VARCHAR)                                            \
-  LT(profession, LogicalType::VARCHAR)                                         \
-  LT(language, LogicalType::VARCHAR)                                           \
-  LT(location, LogicalType::VARCHAR)                                           \
-  LT(keyword, LogicalType::VARCHAR)                                            \
-  LT(company_name, LogicalType::VARCHAR)                                       \
-  LT(title, LogicalType::VARCHAR)                                              \
-  LT(department_name, LogicalType::VARCHAR)                                    \
-  LT(office_location, LogicalType::VARCHAR)                                    \
-  LT(manager_name, LogicalType::VARCHAR)                                       \
-  LT(assistant, LogicalType::VARCHAR)                                          \
-  LT(customer_id, LogicalType::VARCHAR)                                        \
-  LT(primary_telephone, LogicalType::VARCHAR)                                  \
-  LT(business_telephone, LogicalType::VARCHAR)                                 \
-  LT(business_telephone_2, LogicalType::VARCHAR)                               \
-  LT(home_telephone, LogicalType::VARCHAR)                                     \
-  LT(home_telephone_2, LogicalType::VARCHAR)                                   \
-  LT(mobile_telephone, LogicalType::VARCHAR)                                   \
-  LT(car_telephone, LogicalType::VARCHAR)                                      \
-  LT(radio_telephone, LogicalType::VARCHAR)                                    \
-  LT(pager_telephone, LogicalType::VARCHAR)                                    \
-  LT(callback_number, LogicalType::VARCHAR)                                    \
-  LT(other_telephone, LogicalType::VARCHAR)                                    \
-  LT(assistant_telephone, LogicalType::VARCHAR)                                \
-  LT(company_main_phone, LogicalType::VARCHAR)                                 \
-  LT(ttytdd_phone, LogicalType::VARCHAR)                                       \
-  LT(isdn_number, LogicalType::VARCHAR)                                        \
-  LT(telex_number, LogicalType::VARCHAR)                                       \
-  LT(primary_fax, LogicalType::VARCHAR)                                        \
-  LT(business_fax, LogicalType::VARCHAR)                                       \
-  LT(home_fax, LogicalType::VARCHAR)                                           \
-  LT(business_address_street, LogicalType::VARCHAR)                            \
-  LT(business_address_city, LogicalType::VARCHAR)                              \
-  LT(business_address_state, LogicalType::VARCHAR)                             \
-  LT(business_postal_code, LogicalType::VARCHAR)                               \
-  LT(business_address_country, LogicalType::VARCHAR)                           \
-  LT(business_po_box, LogicalType::VARCHAR)                                    \
-  LT(home_address_street, LogicalType::VARCHAR)                                \
-  LT(home_address_city, LogicalType::VARCHAR)                                  \
-  LT(home_address_state, LogicalType::VARCHAR)                                 \
-  LT(home_address_postal_code, LogicalType::VARCHAR)                           \
-  LT(home_address_country, LogicalType::VARCHAR)                               \
-  LT(home_address_po_box, LogicalType::VARCHAR)                                \
-  LT(other_address_street, LogicalType::VARCHAR)                               \
-  LT(other_address_city, LogicalType::VARCHAR)                                 \
-  LT(other_address_state, LogicalType::VARCHAR)                                \
-  LT(other_address_postal_code, LogicalType::VARCHAR)                          \
-  LT(other_address_country, LogicalType::VARCHAR)                              \
-  LT(other_address_po_box, LogicalType::VARCHAR)                               \
-  LT(postal_address, LogicalType::VARCHAR)                                     \
-  LT(personal_home_page, LogicalType::VARCHAR)                                 \
-  LT(business_home_page, LogicalType::VARCHAR)                                 \
-  LT(ftp_site, LogicalType::VARCHAR)                                           \
-  LT(computer_network_name, LogicalType::VARCHAR)                              \
-  LT(mail_permission, LogicalType::BOOLEAN)                                    \
-  LT(send_rich_info, LogicalType::BOOLEAN)                                     \
-  LT(conversation_prohibited, LogicalType::BOOLEAN)                            \
-  LT(disclose_recipients, LogicalType::BOOLEAN)
+  LT(display_name_prefix, LogicalType::VARCHAR,                                \
+     BAG_PROP(std::string, PR_DISPLAY_NAME_PREFIX_A))                          \
+  LT(given_name, LogicalType::VARCHAR, BAG_PROP(std::string, PR_GIVEN_NAME_A)) \
+  LT(middle_name, LogicalType::VARCHAR,                                        \
+     BAG_PROP(std::string, PR_MIDDLE_NAME_A))                                  \
+  LT(surname, LogicalType::VARCHAR, BAG_PROP(std::string, PR_SURNAME_A))       \
+  LT(generation_suffix, LogicalType::VARCHAR,                                  \
+     BAG_PROP(std::string, PR_GENERATION_A))                                   \
+  LT(initials, LogicalType::VARCHAR, BAG_PROP(std::string, PR_INITIALS_A))     \
+  LT(nickname, LogicalType::VARCHAR, BAG_PROP(std::string, PR_NICKNAME_A))     \
+  LT(preferred_by_name, LogicalType::VARCHAR,                                  \
+     BAG_PROP(std::string, PR_PREFERRED_BY_NAME_A))                            \
+  LT(account_name, LogicalType::VARCHAR, BAG_PROP(std::string, PR_ACCOUNT_A))  \
+  LT(original_display_name, LogicalType::VARCHAR,                              \
+     BAG_PROP(std::string, PR_ORIGINAL_DISPLAY_NAME_A))                        \
+  LT(transmittable_display_name, LogicalType::VARCHAR,                         \
+     BAG_PROP(std::string, PR_TRANSMITABLE_DISPLAY_NAME_A))                    \
+  LT(mhs_common_name, LogicalType::VARCHAR,                                    \
+     BAG_PROP(std::string, PR_MHS_COMMON_NAME_A))                              \
+  LT(government_id_number, LogicalType::VARCHAR,                               \
+     BAG_PROP(std::string, PR_GOVERNMENT_ID_NUMBER_A))                         \
+  LT(organizational_id_number, LogicalType::VARCHAR,                           \
+     BAG_PROP(std::string, PR_ORGANIZATIONAL_ID_NUMBER_A))                     \
+  LT(birthday, LogicalType::TIMESTAMP_S,                                       \
+     BAG_PROP(pstsdk::ulonglong, PR_BIRTHDAY))                                 \
+  LT(wedding_anniversary, LogicalType::TIMESTAMP_S,                            \
+     BAG_PROP(pstsdk::ulonglong, PR_WEDDING_ANNIVERSARY))                      \
+  LT(spouse_name, LogicalType::VARCHAR,                                        \
+     BAG_PROP(std::string, PR_SPOUSE_NAME_A))                                  \
+  LT(childrens_names, LogicalType::VARCHAR,                                    \
+     BAG_PROP(std::string, PR_CHILDRENS_NAMES_A))                              \
+  LT(gender, LogicalType::SMALLINT, BAG_PROP(int16_t, PR_GENDER))              \
+  LT(hobbies, LogicalType::VARCHAR, BAG_PROP(std::string, PR_HOBBIES_A))       \
+  LT(profession, LogicalType::VARCHAR, BAG_PROP(std::string, PR_PROFESSION_A)) \
+  LT(language, LogicalType::VARCHAR, BAG_PROP(std::string, PR_LANGUAGE_A))     \
+  LT(location, LogicalType::VARCHAR, BAG_PROP(std::string, PR_LOCATION_A))     \
+  LT(keyword, LogicalType::VARCHAR, BAG_PROP(std::string, PR_KEYWORD_A))       \
+  LT(company_name, LogicalType::VARCHAR,                                       \
+     BAG_PROP(std::string, PR_COMPANY_NAME_A))                                 \
+  LT(title, LogicalType::VARCHAR, BAG_PROP(std::string, PR_TITLE_A))           \
+  LT(department_name, LogicalType::VARCHAR,                                    \
+     BAG_PROP(std::string, PR_DEPARTMENT_NAME_A))                              \
+  LT(office_location, LogicalType::VARCHAR,                                    \
+     BAG_PROP(std::string, PR_OFFICE_LOCATION_A))                              \
+  LT(manager_name, LogicalType::VARCHAR,                                       \
+     BAG_PROP(std::string, PR_MANAGER_NAME_A))                                 \
+  LT(assistant, LogicalType::VARCHAR, BAG_PROP(std::string, PR_ASSISTANT_A))   \
+  LT(customer_id, LogicalType::VARCHAR,                                        \
+     BAG_PROP(std::string, PR_CUSTOMER_ID_A))                                  \
+  LT(primary_telephone, LogicalType::VARCHAR,                                  \
+     BAG_PROP(std::string, PR_PRIMARY_TELEPHONE_NUMBER_A))                     \
+  LT(business_telephone, LogicalType::VARCHAR,                                 \
+     BAG_PROP(std::string, PR_BUSINESS_TELEPHONE_NUMBER_A))                    \
+  LT(business_telephone_2, LogicalType::VARCHAR,                               \
+     BAG_PROP(std::string, PR_BUSINESS2_TELEPHONE_NUMBER_A))                   \
+  LT(home_telephone, LogicalType::VARCHAR,                                     \
+     BAG_PROP(std::string, PR_HOME_TELEPHONE_NUMBER_A))                        \
+  LT(home_telephone_2, LogicalType::VARCHAR,                                   \
+     BAG_PROP(std::string, PR_HOME2_TELEPHONE_NUMBER_A))                       \
+  LT(mobile_telephone, LogicalType::VARCHAR,                                   \
+     BAG_PROP(std::string, PR_MOBILE_TELEPHONE_NUMBER_A))                      \
+  LT(car_telephone, LogicalType::VARCHAR,                                      \
+     BAG_PROP(std::string, PR_CAR_TELEPHONE_NUMBER_A))                         \
+  LT(radio_telephone, LogicalType::VARCHAR,                                    \
+     BAG_PROP(std::string, PR_RADIO_TELEPHONE_NUMBER_A))                       \
+  LT(pager_telephone, LogicalType::VARCHAR,                                    \
+     BAG_PROP(std::string, PR_PAGER_TELEPHONE_NUMBER_A))                       \
+  LT(callback_number, LogicalType::VARCHAR,                                    \
+     BAG_PROP(std::string, PR_CALLBACK_TELEPHONE_NUMBER_A))                    \
+  LT(other_telephone, LogicalType::VARCHAR,                                    \
+     BAG_PROP(std::string, PR_OTHER_TELEPHONE_NUMBER_A))                       \
+  LT(assistant_telephone, LogicalType::VARCHAR,                                \
+     BAG_PROP(std::string, PR_ASSISTANT_TELEPHONE_NUMBER_A))                   \
+  LT(company_main_phone, LogicalType::VARCHAR,                                 \
+     BAG_PROP(std::string, PR_COMPANY_MAIN_PHONE_NUMBER_A))                    \
+  LT(ttytdd_phone, LogicalType::VARCHAR,                                       \
+     BAG_PROP(std::string, PR_TTYTDD_PHONE_NUMBER_A))                          \
+  LT(isdn_number, LogicalType::VARCHAR,                                        \
+     BAG_PROP(std::string, PR_ISDN_NUMBER_A))                                  \
+  LT(telex_number, LogicalType::VARCHAR,                                       \
+     BAG_PROP(std::string, PR_TELEX_NUMBER_A))                                 \
+  LT(primary_fax, LogicalType::VARCHAR,                                        \
+     BAG_PROP(std::string, PR_PRIMARY_FAX_NUMBER_A))                           \
+  LT(business_fax, LogicalType::VARCHAR,                                       \
+     BAG_PROP(std::string, PR_BUSINESS_FAX_NUMBER_A))                          \
+  LT(home_fax, LogicalType::VARCHAR,                                           \
+     BAG_PROP(std::string, PR_HOME_FAX_NUMBER_A))                              \
+  LT(business_address_street, LogicalType::VARCHAR,                            \
+     BAG_PROP(std::string, PR_STREET_ADDRESS_A))                               \
+  LT(business_address_city, LogicalType::VARCHAR,                              \
+     BAG_PROP(std::string, PR_LOCALITY_A))                                     \
+  LT(business_address_state, LogicalType::VARCHAR,                             \
+     BAG_PROP(std::string, PR_STATE_OR_PROVINCE_A))                            \
+  LT(business_postal_code, LogicalType::VARCHAR,                               \
+     BAG_PROP(std::string, PR_POSTAL_CODE_A))                                  \
+  LT(business_address_country, LogicalType::VARCHAR,                           \
+     BAG_PROP(std::string, PR_COUNTRY_A))                                      \
+  LT(business_po_box, LogicalType::VARCHAR,                                    \
+     BAG_PROP(std::string, PR_POST_OFFICE_BOX_A))                              \
+  LT(home_address_street, LogicalType::VARCHAR,                                \
+     BAG_PROP(std::string, PR_HOME_ADDRESS_STREET_A))                          \
+  LT(home_address_city, LogicalType::VARCHAR,                                  \
+     BAG_PROP(std::string, PR_HOME_ADDRESS_CITY_A))                            \
+  LT(home_address_state, LogicalType::VARCHAR,                                 \
+     BAG_PROP(std::string, PR_HOME_ADDRESS_STATE_OR_PROVINCE_A))               \
+  LT(home_address_postal_code, LogicalType::VARCHAR,                           \
+     BAG_PROP(std::string, PR_HOME_ADDRESS_POSTAL_CODE_A))                     \
+  LT(home_address_country, LogicalType::VARCHAR,                               \
+     BAG_PROP(std::string, PR_HOME_ADDRESS_COUNTRY_A))                         \
+  LT(home_address_po_box, LogicalType::VARCHAR,                                \
+     BAG_PROP(std::string, PR_HOME_ADDRESS_POST_OFFICE_BOX_A))                 \
+  LT(other_address_street, LogicalType::VARCHAR,                               \
+     BAG_PROP(std::string, PR_OTHER_ADDRESS_STREET_A))                         \
+  LT(other_address_city, LogicalType::VARCHAR,                                 \
+     BAG_PROP(std::string, PR_OTHER_ADDRESS_CITY_A))                           \
+  LT(other_address_state, LogicalType::VARCHAR,                                \
+     BAG_PROP(std::string, PR_OTHER_ADDRESS_STATE_OR_PROVINCE_A))              \
+  LT(other_address_postal_code, LogicalType::VARCHAR,                          \
+     BAG_PROP(std::string, PR_OTHER_ADDRESS_POSTAL_CODE_A))                    \
+  LT(other_address_country, LogicalType::VARCHAR,                              \
+     BAG_PROP(std::string, PR_OTHER_ADDRESS_COUNTRY_A))                        \
+  LT(other_address_po_box, LogicalType::VARCHAR,                               \
+     BAG_PROP(std::string, PR_OTHER_ADDRESS_POST_OFFICE_BOX_A))                \
+  LT(postal_address, LogicalType::VARCHAR,                                     \
+     BAG_PROP(std::string, PR_POSTAL_ADDRESS_A))                               \
+  LT(personal_home_page, LogicalType::VARCHAR,                                 \
+     BAG_PROP(std::string, PR_PERSONAL_HOME_PAGE_A))                           \
+  LT(business_home_page, LogicalType::VARCHAR,                                 \
+     BAG_PROP(std::string, PR_BUSINESS_HOME_PAGE_A))                           \
+  LT(ftp_site, LogicalType::VARCHAR, BAG_PROP(std::string, PR_FTP_SITE_A))     \
+  LT(computer_network_name, LogicalType::VARCHAR,                              \
+     BAG_PROP(std::string, PR_COMPUTER_NETWORK_NAME_A))                        \
+  LT(mail_permission, LogicalType::BOOLEAN,                                    \
+     BAG_PROP(bool, PR_MAIL_PERMISSION))                                       \
+  LT(send_rich_info, LogicalType::BOOLEAN, BAG_PROP(bool, PR_SEND_RICH_INFO))  \
+  LT(conversation_prohibited, LogicalType::BOOLEAN,                            \
+     BAG_PROP(bool, PR_CONVERSION_PROHIBITED))                                 \
+  LT(disclose_recipients, LogicalType::BOOLEAN,                                \
+     BAG_PROP(bool, PR_DISCLOSE_RECIPIENTS))
 
 enum class ContactProjection {
   PST_CHILDREN(SCHEMA_CHILD_NAME) NOTE_CHILDREN(SCHEMA_CHILD_NAME)
@@ -261,21 +347,42 @@ inline const auto CONTACT_SCHEMA = LogicalType::STRUCT({PST_CHILDREN(
 
 /* Appointment schema */
 #define APPOINTMENT_CHILDREN(LT)                                               \
-  LT(location, LogicalType::VARCHAR)                                           \
-  LT(start_time, LogicalType::TIMESTAMP_S)                                     \
-  LT(end_time, LogicalType::TIMESTAMP_S)                                       \
-  LT(duration, LogicalType::INTEGER)                                           \
-  LT(all_day_event, LogicalType::BOOLEAN)                                      \
-  LT(is_meeting, LogicalType::BOOLEAN)                                         \
-  LT(organizer_name, LogicalType::VARCHAR)                                     \
-  LT(required_attendees, LogicalType::VARCHAR)                                 \
-  LT(optional_attendees, LogicalType::VARCHAR)                                 \
-  LT(meeting_workspace_url, LogicalType::VARCHAR)                              \
-  LT(busy_status, LogicalType::INTEGER)                                        \
-  LT(response_status, LogicalType::INTEGER)                                    \
-  LT(is_recurring, LogicalType::BOOLEAN)                                       \
-  LT(recurrence_pattern, LogicalType::VARCHAR)                                 \
-  LT(is_private, LogicalType::BOOLEAN)
+  LT(location, LogicalType::VARCHAR,                                           \
+     NAMED_PROP(std::string, pstsdk::ps_appointment, PidLidLocation_A))        \
+  LT(start_time, LogicalType::TIMESTAMP_S,                                     \
+     NAMED_PROP(pstsdk::ulonglong, pstsdk::ps_appointment,                     \
+                PidLidAppointmentStartWhole))                                  \
+  LT(end_time, LogicalType::TIMESTAMP_S,                                       \
+     NAMED_PROP(pstsdk::ulonglong, pstsdk::ps_appointment,                     \
+                PidLidAppointmentEndWhole))                                    \
+  LT(duration, LogicalType::INTEGER,                                           \
+     NAMED_PROP(int32_t, pstsdk::ps_appointment, PidLidAppointmentDuration))   \
+  LT(all_day_event, LogicalType::BOOLEAN,                                      \
+     NAMED_PROP(bool, pstsdk::ps_appointment, PidLidAppointmentSubType))       \
+  LT(is_meeting, LogicalType::BOOLEAN,                                         \
+     NAMED_PROP(bool, pstsdk::ps_appointment, PidLidFInvited))                 \
+  LT(organizer_name, LogicalType::VARCHAR,                                     \
+     NAMED_PROP(std::string, pstsdk::ps_appointment, PidLidOwnerName_A))       \
+  LT(required_attendees, LogicalType::VARCHAR,                                 \
+     NAMED_PROP(std::string, pstsdk::ps_appointment,                           \
+                PidLidToAttendeesString_A))                                    \
+  LT(optional_attendees, LogicalType::VARCHAR,                                 \
+     NAMED_PROP(std::string, pstsdk::ps_appointment,                           \
+                PidLidCcAttendeesString_A))                                    \
+  LT(meeting_workspace_url, LogicalType::VARCHAR,                              \
+     NAMED_PROP(std::string, pstsdk::ps_appointment,                           \
+                PidLidMeetingWorkspaceUrl_A))                                  \
+  LT(busy_status, LogicalType::INTEGER,                                        \
+     NAMED_PROP(int32_t, pstsdk::ps_appointment, PidLidBusyStatus))            \
+  LT(response_status, LogicalType::INTEGER,                                    \
+     NAMED_PROP(int32_t, pstsdk::ps_appointment, PidLidResponseStatus))        \
+  LT(is_recurring, LogicalType::BOOLEAN,                                       \
+     NAMED_PROP(bool, pstsdk::ps_appointment, PidLidRecurring))                \
+  LT(recurrence_pattern, LogicalType::VARCHAR,                                 \
+     NAMED_PROP(std::string, pstsdk::ps_appointment,                           \
+                PidLidRecurrencePattern_A))                                    \
+  LT(is_private, LogicalType::BOOLEAN,                                         \
+     COMPUTED_PROP(read_is_private, PR_SENSITIVITY))
 
 enum class AppointmentProjection {
   PST_CHILDREN(SCHEMA_CHILD_NAME) NOTE_CHILDREN(SCHEMA_CHILD_NAME)
@@ -288,11 +395,16 @@ inline const auto APPOINTMENT_SCHEMA =
 
 /* Sticky Note schema */
 #define STICKY_NOTE_CHILDREN(LT)                                               \
-  LT(note_color, LogicalType::INTEGER)                                         \
-  LT(note_width, LogicalType::INTEGER)                                         \
-  LT(note_height, LogicalType::INTEGER)                                        \
-  LT(note_x, LogicalType::INTEGER)                                             \
-  LT(note_y, LogicalType::INTEGER)
+  LT(note_color, LogicalType::INTEGER,                                         \
+     NAMED_PROP(int32_t, pstsdk::ps_note, PidLidNoteColor))                    \
+  LT(note_width, LogicalType::INTEGER,                                         \
+     NAMED_PROP(int32_t, pstsdk::ps_note, PidLidNoteWidth))                    \
+  LT(note_height, LogicalType::INTEGER,                                        \
+     NAMED_PROP(int32_t, pstsdk::ps_note, PidLidNoteHeight))                   \
+  LT(note_x, LogicalType::INTEGER,                                             \
+     NAMED_PROP(int32_t, pstsdk::ps_note, PidLidNoteX))                        \
+  LT(note_y, LogicalType::INTEGER,                                             \
+     NAMED_PROP(int32_t, pstsdk::ps_note, PidLidNoteY))
 
 enum class StickyNoteProjection {
   PST_CHILDREN(SCHEMA_CHILD_NAME) NOTE_CHILDREN(SCHEMA_CHILD_NAME)
@@ -305,21 +417,36 @@ inline const auto STICKY_NOTE_SCHEMA =
 
 /* Task schema */
 #define TASK_CHILDREN(LT)                                                      \
-  LT(task_status, LogicalType::INTEGER)                                        \
-  LT(is_complete, LogicalType::BOOLEAN)                                        \
-  LT(percent_complete, LogicalType::DOUBLE)                                    \
-  LT(start_date, LogicalType::TIMESTAMP_S)                                     \
-  LT(due_date, LogicalType::TIMESTAMP_S)                                       \
-  LT(date_completed, LogicalType::TIMESTAMP_S)                                 \
-  LT(last_update, LogicalType::TIMESTAMP_S)                                    \
-  LT(estimated_effort, LogicalType::INTEGER)                                   \
-  LT(actual_effort, LogicalType::INTEGER)                                      \
-  LT(task_owner, LogicalType::VARCHAR)                                         \
-  LT(task_assigner, LogicalType::VARCHAR)                                      \
-  LT(ownership, LogicalType::INTEGER)                                          \
-  LT(last_user, LogicalType::VARCHAR)                                          \
-  LT(is_team_task, LogicalType::BOOLEAN)                                       \
-  LT(is_recurring, LogicalType::BOOLEAN)
+  LT(task_status, LogicalType::INTEGER,                                        \
+     NAMED_PROP(int32_t, pstsdk::ps_task, PidLidTaskStatus))                   \
+  LT(is_complete, LogicalType::BOOLEAN,                                        \
+     NAMED_PROP(bool, pstsdk::ps_task, PidLidTaskComplete))                    \
+  LT(percent_complete, LogicalType::DOUBLE,                                    \
+     NAMED_PROP(double, pstsdk::ps_task, PidLidPercentComplete))               \
+  LT(start_date, LogicalType::TIMESTAMP_S,                                     \
+     NAMED_PROP(pstsdk::ulonglong, pstsdk::ps_task, PidLidTaskStartDate))      \
+  LT(due_date, LogicalType::TIMESTAMP_S,                                       \
+     NAMED_PROP(pstsdk::ulonglong, pstsdk::ps_task, PidLidTaskDueDate))        \
+  LT(date_completed, LogicalType::TIMESTAMP_S,                                 \
+     NAMED_PROP(pstsdk::ulonglong, pstsdk::ps_task, PidLidTaskDateCompleted))  \
+  LT(last_update, LogicalType::TIMESTAMP_S,                                    \
+     NAMED_PROP(pstsdk::ulonglong, pstsdk::ps_task, PidLidTaskLastUpdate))     \
+  LT(estimated_effort, LogicalType::INTEGER,                                   \
+     NAMED_PROP(int32_t, pstsdk::ps_task, PidLidTaskEstimatedEffort))          \
+  LT(actual_effort, LogicalType::INTEGER,                                      \
+     NAMED_PROP(int32_t, pstsdk::ps_task, PidLidTaskActualEffort))             \
+  LT(task_owner, LogicalType::VARCHAR,                                         \
+     NAMED_PROP(std::string, pstsdk::ps_task, PidLidTaskOwner_A))              \
+  LT(task_assigner, LogicalType::VARCHAR,                                      \
+     NAMED_PROP(std::string, pstsdk::ps_task, PidLidTaskAssigner_A))           \
+  LT(ownership, LogicalType::INTEGER,                                          \
+     NAMED_PROP(int32_t, pstsdk::ps_task, PidLidTaskOwnership))                \
+  LT(last_user, LogicalType::VARCHAR,                                          \
+     NAMED_PROP(std::string, pstsdk::ps_task, PidLidTaskLastUser_A))           \
+  LT(is_team_task, LogicalType::BOOLEAN,                                       \
+     NAMED_PROP(bool, pstsdk::ps_task, PidLidTeamTask))                        \
+  LT(is_recurring, LogicalType::BOOLEAN,                                       \
+     NAMED_PROP(bool, pstsdk::ps_task, PidLidTaskFRecurring))
 
 enum class TaskProjection {
   PST_CHILDREN(SCHEMA_CHILD_NAME) NOTE_CHILDREN(SCHEMA_CHILD_NAME)
@@ -331,8 +458,12 @@ inline const auto TASK_SCHEMA = LogicalType::STRUCT({PST_CHILDREN(
 
 /* Distribution list schema */
 #define DLIST_CHILDREN(LT)                                                     \
-  LT(member_node_ids, LogicalType::LIST(LogicalType::UINTEGER))                \
-  LT(one_off_members, LogicalType::LIST(ONE_OFF_RECIPIENT_SCHEMA))
+  LT(member_node_ids, LogicalType::LIST(LogicalType::UINTEGER),                \
+     COMPUTED_NAMED_PROP(read_member_node_ids, pstsdk::ps_address,             \
+                         PidLidDistributionListMembers))                       \
+  LT(one_off_members, LogicalType::LIST(ONE_OFF_RECIPIENT_SCHEMA),             \
+     COMPUTED_NAMED_PROP(read_one_off_members, pstsdk::ps_address,             \
+                         PidLidDistributionListOneOffMembers))
 
 enum class DistributionListProjection {
   PST_CHILDREN(SCHEMA_CHILD_NAME) NOTE_CHILDREN(SCHEMA_CHILD_NAME)
@@ -345,11 +476,14 @@ inline const auto DLIST_SCHEMA = LogicalType::STRUCT({PST_CHILDREN(
 /* Folder schema */
 
 #define FOLDER_CHILDREN(LT)                                                    \
-  LT(container_class, LogicalType::VARCHAR)                                    \
-  LT(display_name, LogicalType::VARCHAR)                                       \
-  LT(subfolder_count, LogicalType::UINTEGER)                                   \
-  LT(message_count, LogicalType::BIGINT)                                       \
-  LT(unread_message_count, LogicalType::BIGINT)
+  LT(container_class, LogicalType::VARCHAR,                                    \
+     BAG_PROP(std::string, PR_CONTAINER_CLASS_A))                              \
+  LT(display_name, LogicalType::VARCHAR,                                       \
+     BAG_PROP(std::string, PR_DISPLAY_NAME_A))                                 \
+  LT(subfolder_count, LogicalType::UINTEGER, COMPUTED(read_subfolder_count))   \
+  LT(message_count, LogicalType::BIGINT, COMPUTED(read_message_count))         \
+  LT(unread_message_count, LogicalType::BIGINT,                                \
+     COMPUTED(read_unread_message_count))
 
 enum class FolderProjection {
   PST_CHILDREN(SCHEMA_CHILD_NAME) FOLDER_CHILDREN(SCHEMA_CHILD_NAME)
@@ -1,6 +1,10 @@
 #pragma once
 
+#include "scan_filters.hpp"
 #include "schema.hpp"
+#include "pst/block_file.hpp"
+#include "pst/file_index.hpp"
+#include "pst/named_props.hpp"
 #include "pst/typed_bag.hpp"
 
 #include "duckdb/common/named_parameter_map.hpp"
@@ -22,6 +26,9 @@
 #include <boost/range/combine.hpp>
 #include <boost/thread/synchronized_value.hpp>
 
+#include <functional>
+#include <mutex>
+
 namespace intellekt::duckpst {
 using namespace duckdb;
 using namespace pstsdk;
@@ -29,6 +36,12 @@ using namespace pstsdk;
 static constexpr idx_t DEFAULT_PARTITION_SIZE =
     DEFAULT_STANDARD_VECTOR_SIZE * 2;
 static constexpr idx_t DEFAULT_BODY_SIZE_BYTES = 1000000;
+static constexpr idx_t DEFAULT_MAX_OPEN_FILES = 64;
+
+// Bytes of a PST per row, for cardinality estimates of unplanned files
+// (messages carry their bodies and attachments, folders their tables)
+static constexpr idx_t ESTIMATED_MESSAGE_BYTES = 32 * 1024;
+static constexpr idx_t ESTIMATED_FOLDER_BYTES = 1024 * 1024;
 
 /**
  * @brief Determines output shape and nid filters
@@ -65,6 +78,23 @@ inline const LogicalType &output_schema(const PSTReadFunctionMode &mode) {
   }
 }
 
+/**
+ * @brief Where message rows are read from
+ */
+enum class PSTScanMode {
+  // Contents tables when every projected column is one they usually hold
+  Auto,
+  // Each message's own node
+  Node,
+  // Folder contents tables (messages missing from them are read from nodes)
+  ContentsTable
+};
+
+inline const map<string, PSTScanMode> SCAN_MODES = {
+    {"auto", PSTScanMode::Auto},
+    {"node", PSTScanMode::Node},
+    {"contents_table", PSTScanMode::ContentsTable}};
+
 inline const map<string, PSTReadFunctionMode> FUNCTIONS = {
     {"read_pst_folders", Folder},
     {"read_pst_messages", Message},
@@ -78,8 +108,84 @@ inline const map<string, PSTReadFunctionMode> FUNCTIONS = {
 inline const named_parameter_type_map_t NAMED_PARAMETERS = {
     {"read_body_size_bytes", LogicalType::UBIGINT},
     {"partition_size", LogicalType::UBIGINT},
+    {"partition_bytes", LogicalType::UBIGINT},
     {"read_attachment_body", LogicalType::BOOLEAN},
-    {"read_limit", LogicalType::UBIGINT}};
+    {"read_limit", LogicalType::UBIGINT},
+    {"scan_mode", LogicalType::VARCHAR}};
+
+// Partitions are numbered by their file's position in the glob, then by
+// their position in the file, so every scan of a read (e.g. both scans of a
+// late materialized query) numbers them the same, whoever plans them
+static constexpr idx_t PARTITION_ORDINAL_BITS = 32;
+
+/**
+ * @brief Handles of a mounted PST file. Partitions share them, so the file is
+ * closed once the last partition planned from it is done.
+ */
+struct PSTMountedFile {
+  // The PST object is _not_ thread safe, and is intended to be copied on bind
+  // for use!
+  shared_ptr<pstsdk::pst> pst;
+
+  // The file pstsdk reads through (shared by the pst copies), used to fetch
+  // blocks in batches ahead of the reads
+  std::shared_ptr<pst::block_file> blocks;
+
+  // Named prop IDs of the file, shared by every partition of it
+  shared_ptr<pst::NamedPropCache> named_props;
+
+  // Sidecar index, if enabled and current
+  std::shared_ptr<const pst::FileIndex> index;
+
+  // Where messages are in their folders' contents tables, recorded while
+  // planning scans that read rows from them (set before the first partition
+  // of the file is handed out)
+  std::shared_ptr<const pst::ContentsRows> contents_rows;
+
+  // Messages whose contents table rows put them within the pushed down time
+  // ranges while planning, which scans don't check again
+  std::shared_ptr<const pst::NodeIds> in_time_ranges;
+
+  // Called once the file is closed, when its last handle is dropped (on
+  // whichever thread drops it, possibly holding any lock)
+  std::function<void()> on_release;
+
+  PSTMountedFile() = default;
+  PSTMountedFile(const PSTMountedFile &) = delete;
+  ~PSTMountedFile();
+};
+
+/**
+ * @brief A PST file of the read. Its header is validated at bind, but it is
+ * only mounted (again) while it is planned and read.
+ */
+struct PSTInputFile {
+  OpenFileInfo file;
+
+  // Position of the file in the glob (kept when filters drop other files)
+  idx_t file_index;
+
+  // Size of the file in bytes, for estimates
+  idx_t size;
+
+  /**
+   * @brief Index of the file's ordinal-th partition
+   *
+   * @param ordinal
+   * @return idx_t
+   */
+  idx_t partition_index(idx_t ordinal) const {
+    return (file_index << PARTITION_ORDINAL_BITS) | ordinal;
+  }
+
+  /**
+   * @brief Open and mount the file, loading its sidecar index if enabled
+   *
+   * @param ctx
+   * @return shared_ptr<PSTMountedFile>
+   */
+  shared_ptr<PSTMountedFile> mount(ClientContext &ctx) const;
+};
 
 /**
  * A PST read as expressed by node IDs in a file
@@ -87,9 +193,9 @@ inline const named_parameter_type_map_t NAMED_PARAMETERS = {
 struct PSTInputPartition {
   const idx_t partition_index;
 
-  // The PST object is _not_ thread safe, and is intended to be copied on bind
-  // for use!
-  const shared_ptr<pstsdk::pst> pst;
+  // NULL for partitions planned before the scan, which don't keep their file
+  // open (the scan mounts it again when it hands them out)
+  shared_ptr<PSTMountedFile> mounted;
 
   const OpenFileInfo file;
   const PSTReadFunctionMode mode;
@@ -97,19 +203,74 @@ struct PSTInputPartition {
   vector<node_id> nodes;
 
   PSTInputPartition(const idx_t partition_index,
-                    const shared_ptr<pstsdk::pst> pst, const OpenFileInfo file,
-                    const PSTReadFunctionMode mode,
+                    const shared_ptr<PSTMountedFile> mounted,
+                    const OpenFileInfo file, const PSTReadFunctionMode mode,
                     const PartitionStatistics stats,
                     const vector<node_id> &&nodes);
   PSTInputPartition(const PSTInputPartition &other_partition);
 };
 
+/**
+ * @brief Receives the partitions of a file as they are planned
+ */
+class PSTPartitionSink {
+public:
+  virtual ~PSTPartitionSink() = default;
+
+  /**
+   * @brief Rows that may still be planned (read_limit); planning stops at 0
+   *
+   * @return idx_t
+   */
+  virtual idx_t remaining_rows() = 0;
+
+  /**
+   * @brief May planning build (and save) sidecar indexes? Only scans do, not
+   * planning for the optimizer (e.g. for an EXPLAIN).
+   *
+   * @return bool
+   */
+  virtual bool builds_index() const { return false; }
+
+  /**
+   * @brief Will the scan read message rows from folder contents tables? If
+   * so, planning records where the rows are, and orders each partition's
+   * nodes by folder and table row.
+   *
+   * @return bool
+   */
+  virtual bool reads_contents_tables() const { return false; }
+
+  /**
+   * @brief Add a partition of (at most partition_size) nodes, or fewer if
+   * their bytes reach partition_bytes
+   *
+   * @param input The file the nodes belong to
+   * @param mounted Its handles
+   * @param partition_index See PSTInputFile::partition_index
+   * @param nodes
+   */
+  virtual void add_partition(const PSTInputFile &input,
+                             const shared_ptr<PSTMountedFile> &mounted,
+                             idx_t partition_index,
+                             vector<node_id> &&nodes) = 0;
+};
+
 struct PSTReadTableFunctionData : public TableFunctionData {
   vector<OpenFileInfo> files;
-  boost::synchronized_value<vector<PSTInputPartition>> partitions;
+
+  // Files with a valid header, in glob order
+  vector<PSTInputFile> inputs;
+
+  // Partitions of inputs planned before the scan, for exact partition stats
+  // (otherwise inputs are all planned while scanning, see PSTReadGlobalState)
+  mutable boost::synchronized_value<vector<PSTInputPartition>> partitions;
 
   duckdb::named_parameter_map_t named_parameters;
 
+  // Identity column predicates pushed down from the query
+  PSTScanFilters filters;
+
 public:
   const PSTReadFunctionMode mode;
 
@@ -128,9 +289,11 @@ public:
 
   // Parameters
   const idx_t partition_size() const;
+  const idx_t partition_bytes() const;
   const idx_t read_body_size_bytes() const;
   const bool read_attachment_body() const;
   const idx_t read_limit() const;
+  const PSTScanMode scan_mode() const;
 
   /**
    * @brief Bind table function output schema based on read mode
@@ -142,20 +305,63 @@ public:
                                          vector<string> &names);
 
   /**
-   * @brief Plan all partitions for all files
+   * @brief Validate the headers of all files (in parallel), skipping those
+   * that can't be read. Files are closed again right after.
    *
    * @param ctx
    */
-  void plan_input_partitions(ClientContext &ctx);
+  void validate_input_files(ClientContext &ctx);
 
   /**
-   * @brief Mount a PST and bucket it into partitions, optionally applying a
-   * message_class filter depending on the read mode
+   * @brief Narrow the read to pushed down filters: inputs that can't match
+   * are dropped. Planning happens after, see plan_bind_partitions.
    *
-   * @param pst
+   * @param ctx
+   * @param scan_filters
+   */
+  void apply_filters(ClientContext &ctx, PSTScanFilters &&scan_filters);
+
+  /**
+   * @brief Plan the partitions of the first input_count inputs into
+   * partitions (if they weren't already), for exact partition stats. Only
+   * called once the filters are final, so each input is planned once.
+   *
+   * @param ctx
+   * @param input_count
+   */
+  void plan_bind_partitions(ClientContext &ctx, idx_t input_count) const;
+
+  /**
+   * @brief Number of inputs whose partitions were planned before the scan
+   *
+   * @return idx_t
    */
-  void plan_file_partitions(ClientContext &ctx, OpenFileInfo &file,
-                            idx_t limit);
+  idx_t planned_inputs() const;
+
+  /**
+   * @brief Rows of the planned inputs, plus an estimate for the rest based on
+   * their sizes (see ESTIMATED_MESSAGE_BYTES)
+   *
+   * @return idx_t
+   */
+  idx_t estimated_rows() const;
+
+  /**
+   * @brief Bucket the nodes of a PST into partitions, optionally applying a
+   * message_class filter depending on the read mode. Partitions are handed
+   * to the sink as soon as they are formed, in ascending NID order (that of
+   * the NBT, which the sidecar index keeps), though the nodes of a partition
+   * are ordered by folder and table row for contents table scans. Nodes come
+   * from the file's sidecar index when there is one.
+   *
+   * @param ctx
+   * @param input
+   * @param mounted The input, mounted
+   * @param sink
+   */
+  void plan_file_partitions(ClientContext &ctx, const PSTInputFile &input,
+                            const shared_ptr<PSTMountedFile> &mounted,
+                            PSTPartitionSink &sink) const;
 
   /**
    * @brief Copy this function data (used by late materialization)
@@ -165,16 +371,51 @@ public:
   unique_ptr<FunctionData> Copy() const override;
 
 private:
+  /**
+   * @brief Is a NID (from a node_id filter) a node of this read?
+   *
+   * @param pst
+   * @param id
+   */
+  bool node_matches(const pstsdk::pst &pst, node_id id) const;
+
+  /**
+   * @brief Is a message of this read's mode, and does it pass the class
+   * filters?
+   *
+   * @param classify
+   * @param id
+   */
+  bool message_matches(const pst::MessageClassifier &classify,
+                       node_id id) const;
+
   template <typename T>
   const T parameter_or_default(const char *parameter_name,
                                T default_value) const;
+
+  mutable std::mutex planning_lock;
+  mutable idx_t planned_input_count = 0;
 };
 
+/**
+ * @brief Size of a planning worker pool: DuckDB's `threads` setting, but no
+ * more workers than tasks
+ *
+ * @param ctx
+ * @param tasks
+ * @return idx_t
+ */
+idx_t planning_workers(ClientContext &ctx, idx_t tasks);
+
 unique_ptr<FunctionData> PSTReadBind(ClientContext &ctx,
                                      TableFunctionBindInput &input,
                                      vector<LogicalType> &return_types,
                                      vector<string> &names);
 
+void PSTPushdownComplexFilter(ClientContext &ctx, LogicalGet &get,
+                              FunctionData *bind_data,
+                              vector<unique_ptr<Expression>> &filters);
+
 unique_ptr<GlobalTableFunctionState>
 PSTReadInitGlobal(ClientContext &ctx, TableFunctionInitInput &input);
 
@@ -188,6 +429,9 @@ unique_ptr<NodeStatistics> PSTReadCardinality(ClientContext &ctx,
 TablePartitionInfo PSTPartitionInfo(ClientContext &ctx,
                                     TableFunctionPartitionInput &input);
 
+OperatorPartitionData
+PSTReadPartitionData(ClientContext &ctx, TableFunctionGetPartitionInput &input);
+
 vector<PartitionStatistics> PSTPartitionStats(ClientContext &ctx,
                                               GetPartitionStatsInput &input);
 
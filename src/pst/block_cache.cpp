@@ -0,0 +1,110 @@
+#include "pst/block_cache.hpp"
+
+#include <algorithm>
+#include <functional>
+
+namespace intellekt::duckpst::pst {
+
+BlockCache &BlockCache::instance() {
+  static BlockCache cache;
+  return cache;
+}
+
+size_t BlockCache::KeyHash::operator()(const Key &key) const {
+  size_t h = std::hash<uint64_t>()(key.file_id);
+  h ^= std::hash<pstsdk::ulonglong>()(key.offset) + 0x9e3779b97f4a7c15ULL +
+       (h << 6) + (h >> 2);
+  h ^= std::hash<size_t>()(key.size) + 0x9e3779b97f4a7c15ULL + (h << 6) +
+       (h >> 2);
+  return h;
+}
+
+BlockCache::Shard &BlockCache::shard_for(const Key &key) {
+  return shards[KeyHash()(key) % NUM_SHARDS];
+}
+
+void BlockCache::Shard::evict_to(size_t capacity) {
+  while (size > capacity && !lru.empty()) {
+    auto &victim = lru.back();
+    size -= victim.data.size();
+    entries.erase(victim.key);
+    lru.pop_back();
+  }
+}
+
+static thread_local BlockCache::Usage this_thread_usage;
+
+BlockCache::Usage BlockCache::thread_usage() { return this_thread_usage; }
+
+uint64_t BlockCache::file_id(const std::string &identity) {
+  return std::hash<std::string>()(identity);
+}
+
+bool BlockCache::lookup(uint64_t file_id, pstsdk::ulonglong offset,
+                        std::vector<pstsdk::byte> &buffer) {
+  if (capacity() == 0 || buffer.size() > MAX_ENTRY_SIZE)
+    return false;
+
+  Key key{file_id, offset, buffer.size()};
+  auto &shard = shard_for(key);
+
+  {
+    std::lock_guard<std::mutex> guard(shard.lock);
+    auto maybe_entry = shard.entries.find(key);
+    if (maybe_entry != shard.entries.end()) {
+      auto &entry = maybe_entry->second;
+      shard.lru.splice(shard.lru.begin(), shard.lru, entry);
+      std::copy(entry->data.begin(), entry->data.end(), buffer.begin());
+      ++hit_count;
+      ++this_thread_usage.hits;
+      return true;
+    }
+  }
+
+  ++miss_count;
+  ++this_thread_usage.misses;
+  return false;
+}
+
+bool BlockCache::contains(uint64_t file_id, pstsdk::ulonglong offset,
+                          size_t size) {
+  Key key{file_id, offset, size};
+  auto &shard = shard_for(key);
+
+  std::lock_guard<std::mutex> guard(shard.lock);
+  return shard.entries.find(key) != shard.entries.end();
+}
+
+void BlockCache::insert(uint64_t file_id, pstsdk::ulonglong offset,
+                        const std::vector<pstsdk::byte> &buffer) {
+  auto capacity = shard_capacity();
+  if (capacity == 0 || buffer.size() > MAX_ENTRY_SIZE ||
+      buffer.size() > capacity)
+    return;
+
+  Key key{file_id, offset, buffer.size()};
+  auto &shard = shard_for(key);
+
+  std::lock_guard<std::mutex> guard(shard.lock);
+
+  // Another thread may have read (and cached) the same block meanwhile
+  if (shard.entries.find(key) != shard.entries.end())
+    return;
+
+  shard.lru.push_front(Entry{key, buffer});
+  shard.entries.emplace(key, shard.lru.begin());
+  shard.size += buffer.size();
+  shard.evict_to(capacity);
+}
+
+void BlockCache::set_capacity(size_t capacity) {
+  total_capacity = capacity;
+
+  auto per_shard = shard_capacity();
+  for (auto &shard : shards) {
+    std::lock_guard<std::mutex> guard(shard.lock);
+    shard.evict_to(per_shard);
+  }
+}
+
+} // namespace intellekt::duckpst::pst
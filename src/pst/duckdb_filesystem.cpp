@@ -1,23 +1,318 @@
 #include "duckdb/common/file_open_flags.hpp"
+#include "duckdb/common/types/timestamp.hpp"
 #include "duckdb/logging/logger.hpp"
 #include "duckdb/main/client_context.hpp"
+#include "pst/block_cache.hpp"
 #include "pst/duckdb_filesystem.hpp"
+#include "pst/mmap_file.hpp"
 #include "pstsdk/util/util.h"
 
+#include <algorithm>
+#include <exception>
 #include <memory>
+#include <string>
 
 namespace intellekt::duckpst::pst {
 using namespace duckdb;
 
-dfile::dfile(ClientContext &ctx, const OpenFileInfo &file) : pstsdk::file() {
-  auto &fs = FileSystem::GetFileSystem(ctx);
+// First readahead of a sequential stream, doubled on every further miss
+static constexpr uint64_t MIN_READAHEAD_SIZE = 64 * 1024;
+
+// Reader threads with a readahead window of their own (per file); the least
+// recently used window is dropped to make room for another thread's
+static constexpr size_t MAX_READ_STREAMS = 16;
+
+// I/O threads reading prefetched blocks of a file, and runs of blocks they
+// may have queued (prefetching is advisory, so runs past that are dropped)
+static constexpr size_t PREFETCH_THREADS = 2;
+static constexpr size_t MAX_PREFETCH_RUNS = 64;
+
+// Enough to cover the header of either format in one read
+static constexpr uint64_t HEADER_READ_SIZE = 4096;
+static constexpr uint64_t HEADER_PAGE_SIZE = 512;
+static constexpr uint64_t PAGE_SIZE = 512;
+
+// ROOT BREFs (ib) of the NBT and BBT per format
+static constexpr uint64_t UNICODE_NBT_ROOT_OFFSET = 224;
+static constexpr uint64_t UNICODE_BBT_ROOT_OFFSET = 240;
+static constexpr uint64_t ANSI_NBT_ROOT_OFFSET = 188;
+static constexpr uint64_t ANSI_BBT_ROOT_OFFSET = 196;
+
+template <typename T>
+static T setting_or_default(ClientContext &ctx, const char *name,
+                            T default_value) {
+  Value value;
+  if (ctx.TryGetCurrentSetting(name, value) && !value.IsNull())
+    return value.GetValue<T>();
+  return default_value;
+}
+
+static uint64_t read_le(const std::vector<pstsdk::byte> &data, uint64_t offset,
+                        size_t width) {
+  uint64_t value = 0;
+  for (size_t i = 0; i < width; ++i)
+    value |= static_cast<uint64_t>(data[offset + i]) << (8 * i);
+  return value;
+}
+
+dfile::dfile(ClientContext &ctx, const OpenFileInfo &file)
+    : block_file(), fs(FileSystem::GetFileSystem(ctx)), file_info(file) {
   file_handle = fs.OpenFile(file, FileOpenFlags::FILE_FLAGS_READ);
+  file_size = file_handle->GetFileSize();
+
+  readahead_size = setting_or_default(ctx, "pst_readahead_size",
+                                      DEFAULT_READAHEAD_SIZE);
+  gap_threshold = setting_or_default(ctx, "pst_read_gap_threshold",
+                                     DEFAULT_READ_GAP_THRESHOLD);
+
+  // A rewritten file must not be served stale blocks, so its size and
+  // modification time are part of its cache identity
+  try {
+    auto modified = fs.GetLastModifiedTime(*file_handle);
+    modified_time = Timestamp::GetEpochSeconds(modified);
+  } catch (std::exception &) {
+    // Not every filesystem can tell
+  }
+
+  auto identity = file.path + ":" + std::to_string(file_size) + ":" +
+                  std::to_string(modified_time);
+
+  cache_file_id = BlockCache::file_id(identity);
+
+  prefetch_root_pages();
+}
+
+dfile::~dfile() {
+  {
+    std::lock_guard<std::mutex> guard(prefetch_lock);
+    prefetch_stopping = true;
+  }
+  prefetch_ready.notify_all();
+
+  for (auto &thread : prefetch_threads)
+    thread.join();
+}
+
+void dfile::prefetch_root_pages() {
+  if (file_size < HEADER_PAGE_SIZE)
+    return;
+
+  std::vector<pstsdk::byte> header(std::min(HEADER_READ_SIZE, file_size));
+  file_handle->Read(header.data(), header.size(), 0);
+
+  header_crc = read_le(header, HEADER_CRC_OFFSET, 4);
+  unicode =
+      read_le(header, HEADER_VERSION_OFFSET, 2) >= HEADER_UNICODE_MIN_VERSION;
+  uint64_t nbt_root = unicode ? read_le(header, UNICODE_NBT_ROOT_OFFSET, 8)
+                              : read_le(header, ANSI_NBT_ROOT_OFFSET, 4);
+  uint64_t bbt_root = unicode ? read_le(header, UNICODE_BBT_ROOT_OFFSET, 8)
+                              : read_le(header, ANSI_BBT_ROOT_OFFSET, 4);
+
+  for (auto root : {nbt_root, bbt_root}) {
+    // Corrupt headers are pstsdk's to report
+    if (root < HEADER_PAGE_SIZE || root + PAGE_SIZE > file_size)
+      continue;
+
+    std::vector<pstsdk::byte> page(PAGE_SIZE);
+    file_handle->Read(page.data(), page.size(), root);
+    root_pages.emplace(root, std::move(page));
+  }
+
+  // pstsdk reads the header next (on this thread)
+  std::lock_guard<std::mutex> guard(streams_lock);
+  auto &stream = this_stream();
+  stream.window_offset = 0;
+  stream.window = std::move(header);
+}
+
+dfile::ReadStream &dfile::this_stream() const {
+  auto thread = std::this_thread::get_id();
+  auto stream = streams.find(thread);
+  if (stream == streams.end()) {
+    if (streams.size() >= MAX_READ_STREAMS) {
+      auto stale = std::min_element(
+          streams.begin(), streams.end(), [](auto &left, auto &right) {
+            return left.second.last_used < right.second.last_used;
+          });
+      streams.erase(stale);
+    }
+    stream = streams.emplace(thread, ReadStream()).first;
+  }
+
+  stream->second.last_used = ++stream_uses;
+  return stream->second;
+}
+
+void dfile::read_through(std::vector<pstsdk::byte> &buffer,
+                         uint64_t offset) const {
+  uint64_t read_size = buffer.size();
+  uint64_t read_end = offset + read_size;
+
+  auto root_page = root_pages.find(offset);
+  if (root_page != root_pages.end() && root_page->second.size() == read_size) {
+    std::copy(root_page->second.begin(), root_page->second.end(),
+              buffer.begin());
+    return;
+  }
+
+  uint64_t fetch_size = read_size;
+  {
+    std::lock_guard<std::mutex> guard(streams_lock);
+    auto &stream = this_stream();
+
+    // Forward reads skipping at most gap_threshold bytes are cheaper to
+    // coalesce than to issue separately
+    bool sequential = offset >= stream.last_end &&
+                      offset - stream.last_end <= gap_threshold;
+    stream.last_end = read_end;
+
+    if (offset >= stream.window_offset &&
+        read_end <= stream.window_offset + stream.window.size()) {
+      std::copy_n(stream.window.begin() + (offset - stream.window_offset),
+                  read_size, buffer.begin());
+      return;
+    }
+
+    stream.sequential_reads = sequential ? stream.sequential_reads + 1 : 0;
+    if (readahead_size == 0 || stream.sequential_reads < 2) {
+      stream.next_readahead = 0;
+    } else {
+      stream.next_readahead =
+          stream.next_readahead == 0
+              ? std::min(MIN_READAHEAD_SIZE, readahead_size)
+              : std::min(stream.next_readahead * 2, readahead_size);
+
+      // Don't read ahead past EOF
+      if (read_end < file_size)
+        fetch_size = std::max(read_size, std::min(stream.next_readahead,
+                                                  file_size - offset));
+    }
+  }
+
+  if (fetch_size == read_size) {
+    file_handle->Read(buffer.data(), read_size, offset);
+    return;
+  }
+
+  std::vector<pstsdk::byte> window(fetch_size);
+  file_handle->Read(window.data(), fetch_size, offset);
+  std::copy_n(window.begin(), read_size, buffer.begin());
+
+  std::lock_guard<std::mutex> guard(streams_lock);
+  auto &stream = this_stream();
+  stream.window_offset = offset;
+  stream.window = std::move(window);
+}
+
+void dfile::prefetch(const std::vector<BlockRange> &blocks) const {
+  // Prefetched blocks are handed over through the block cache
+  auto &cache = BlockCache::instance();
+  if (cache.capacity() == 0)
+    return;
+
+  std::vector<std::pair<uint64_t, uint64_t>> missing;
+  for (auto &block : blocks) {
+    auto size = disk_block_size(block.size);
+    if (block.address + size > file_size ||
+        cache.contains(cache_file_id, block.address, size))
+      continue;
+    missing.emplace_back(block.address, size);
+  }
+
+  if (missing.empty())
+    return;
+
+  std::sort(missing.begin(), missing.end());
+  missing.erase(std::unique(missing.begin(), missing.end()), missing.end());
+
+  // Blocks no further apart than the gap threshold are read in one request
+  // (of at most a readahead window)
+  auto max_run = std::max(readahead_size, MIN_READAHEAD_SIZE);
+  std::vector<PrefetchRun> runs;
+  for (auto &block : missing) {
+    auto block_end = block.first + block.second;
+    if (runs.empty() || block.first > runs.back().end + gap_threshold ||
+        block_end - runs.back().begin > max_run)
+      runs.push_back(PrefetchRun{block.first, block_end, {}});
+
+    auto &run = runs.back();
+    run.end = std::max(run.end, block_end);
+    run.blocks.push_back(block);
+  }
+
+  std::lock_guard<std::mutex> guard(prefetch_lock);
+  for (auto &run : runs) {
+    if (prefetch_runs.size() >= MAX_PREFETCH_RUNS)
+      break;
+    prefetch_runs.push_back(std::move(run));
+  }
+
+  // The I/O threads start with the first prefetch, so files that are only
+  // planned (or mapped) never get any
+  while (prefetch_threads.size() <
+         std::min(PREFETCH_THREADS, prefetch_runs.size()))
+    prefetch_threads.emplace_back(&dfile::prefetch_queued_runs, this);
+
+  prefetch_ready.notify_all();
+}
+
+void dfile::prefetch_queued_runs() const {
+  auto &cache = BlockCache::instance();
+
+  // The reader threads share file_handle, so this thread reads through a
+  // handle of its own
+  duckdb::unique_ptr<FileHandle> handle;
+
+  while (true) {
+    PrefetchRun run;
+    {
+      std::unique_lock<std::mutex> guard(prefetch_lock);
+      prefetch_ready.wait(guard, [&]() {
+        return prefetch_stopping || !prefetch_runs.empty();
+      });
+      if (prefetch_stopping)
+        return;
+
+      run = std::move(prefetch_runs.front());
+      prefetch_runs.pop_front();
+    }
+
+    // Readers may have got to the blocks first
+    auto cached = std::all_of(
+        run.blocks.begin(), run.blocks.end(), [&](const auto &block) {
+          return cache.contains(cache_file_id, block.first, block.second);
+        });
+    if (cached)
+      continue;
+
+    try {
+      if (!handle)
+        handle = fs.OpenFile(file_info, FileOpenFlags::FILE_FLAGS_READ);
+
+      std::vector<pstsdk::byte> data(run.end - run.begin);
+      handle->Read(data.data(), data.size(), run.begin);
+      for (auto &[address, size] : run.blocks) {
+        auto block_begin = data.begin() + (address - run.begin);
+        cache.insert(cache_file_id, address,
+                     std::vector<pstsdk::byte>(block_begin,
+                                               block_begin + size));
+      }
+    } catch (std::exception &) {
+      // pstsdk will run into (and report) the same error
+    }
+  }
 }
 
 size_t dfile::read(std::vector<pstsdk::byte> &buffer,
                    pstsdk::ulonglong offset) const {
   idx_t read_size = buffer.size();
-  file_handle->Read(&buffer.data()[0], read_size, offset);
+
+  auto &cache = BlockCache::instance();
+  if (cache.lookup(cache_file_id, offset, buffer))
+    return read_size;
+
+  read_through(buffer, offset);
+  cache.insert(cache_file_id, offset, buffer);
   return read_size;
 }
 
@@ -30,8 +325,33 @@ size_t dfile::write(const std::vector<pstsdk::byte> &buffer,
       write_size);
 }
 
-std::shared_ptr<pstsdk::file> dfile::open(duckdb::ClientContext &ctx,
-                                          const duckdb::OpenFileInfo &finfo) {
+std::shared_ptr<block_file> dfile::open(duckdb::ClientContext &ctx,
+                                        const duckdb::OpenFileInfo &finfo) {
+#ifndef _WIN32
+  // Local files are mapped, unless that's disabled or the mapping fails (in
+  // which case the DuckDB file system will report why). They are opened
+  // through the DuckDB file system first, so its access restrictions
+  // (enable_external_access, allowed_directories, disabled_filesystems) apply
+  // to mapped files too.
+  bool local = finfo.path.find("://") == string::npos &&
+               !FileSystem::IsRemoteFile(finfo.path);
+  if (local && setting_or_default(ctx, "pst_mmap", true)) {
+    auto &fs = FileSystem::GetFileSystem(ctx);
+    auto handle = fs.OpenFile(finfo, FileOpenFlags::FILE_FLAGS_READ);
+    if (handle->file_system.GetName() == "LocalFileSystem") {
+      auto readahead_size = setting_or_default(ctx, "pst_readahead_size",
+                                               DEFAULT_READAHEAD_SIZE);
+      auto gap_threshold = setting_or_default(ctx, "pst_read_gap_threshold",
+                                              DEFAULT_READ_GAP_THRESHOLD);
+      auto mapped = mfile::open(fs.ExpandPath(handle->GetPath()),
+                                handle->GetFileSize(), readahead_size,
+                                gap_threshold);
+      if (mapped)
+        return mapped;
+    }
+  }
+#endif
+
   return std::make_shared<dfile>(ctx, finfo);
 }
 
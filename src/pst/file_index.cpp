@@ -0,0 +1,235 @@
+#include "pst/file_index.hpp"
+#include "pst/typed_bag.hpp"
+
+#include "duckdb/common/file_open_flags.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/common/types/hash.hpp"
+#include "duckdb/logging/logger.hpp"
+
+#include <atomic>
+#include <cstring>
+#include <exception>
+#include <random>
+
+namespace intellekt::duckpst::pst {
+using namespace duckdb;
+
+static constexpr char INDEX_MAGIC[8] = {'D', 'U', 'C', 'K', 'P', 'S', 'T', 'I'};
+static constexpr uint32_t INDEX_VERSION = 1;
+static constexpr const char *INDEX_EXTENSION = ".pstidx";
+
+/**
+ * @brief Bounds-checked reader over a serialized index
+ */
+class IndexReader {
+  const std::string &data;
+  size_t offset = 0;
+
+public:
+  explicit IndexReader(const std::string &data) : data(data) {}
+
+  bool read(void *target, size_t size) {
+    if (size > data.size() - offset)
+      return false;
+    std::memcpy(target, data.data() + offset, size);
+    offset += size;
+    return true;
+  }
+
+  template <typename T> bool read(T &value) {
+    return read(&value, sizeof(T));
+  }
+
+  template <typename T> bool read(std::vector<T> &values) {
+    uint64_t count;
+    if (!read(count) || count > (data.size() - offset) / sizeof(T))
+      return false;
+    values.resize(count);
+    return read(values.data(), count * sizeof(T));
+  }
+};
+
+template <typename T> static void write(std::string &out, const T &value) {
+  out.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template <typename T>
+static void write(std::string &out, const std::vector<T> &values) {
+  write<uint64_t>(out, values.size());
+  out.append(reinterpret_cast<const char *>(values.data()),
+             values.size() * sizeof(T));
+}
+
+/**
+ * @brief A file's path as recorded in (and hashed into the name of) its
+ * index: expanded, absolute and without `.` or `..` components, so every
+ * spelling of a local path shares one index
+ */
+static std::string indexed_path(FileSystem &fs, const std::string &path) {
+  auto expanded = fs.ExpandPath(path);
+  if (expanded.find("://") != std::string::npos ||
+      FileSystem::IsRemoteFile(expanded))
+    return expanded;
+
+  if (!fs.IsPathAbsolute(expanded))
+    expanded = fs.JoinPath(fs.GetWorkingDirectory(), expanded);
+
+  auto separator = fs.PathSeparator(expanded);
+  std::vector<std::string> components;
+  size_t begin = 0;
+  while (begin <= expanded.size()) {
+    auto end = expanded.find(separator, begin);
+    if (end == std::string::npos)
+      end = expanded.size();
+
+    auto component = expanded.substr(begin, end - begin);
+    if (component == ".." && !components.empty() &&
+        !components.back().empty())
+      components.pop_back();
+    else if (component != "." && (component != "" || components.empty()))
+      components.emplace_back(std::move(component));
+
+    begin = end + separator.size();
+  }
+
+  std::string normalized;
+  for (idx_t i = 0; i < components.size(); ++i) {
+    if (i > 0)
+      normalized += separator;
+    normalized += components[i];
+  }
+  return normalized;
+}
+
+static std::string index_path(ClientContext &ctx, FileSystem &fs,
+                              const std::string &path) {
+  Value directory;
+  if (ctx.TryGetCurrentSetting("pst_index_directory", directory) &&
+      !directory.IsNull() && !directory.ToString().empty()) {
+    // The full path is stored in the index, so hash collisions are detected
+    auto name = std::to_string(Hash(path.c_str())) + INDEX_EXTENSION;
+    return fs.JoinPath(directory.ToString(), name);
+  }
+
+  return path + INDEX_EXTENSION;
+}
+
+bool FileIndex::enabled(ClientContext &ctx) {
+  Value value;
+  return ctx.TryGetCurrentSetting("pst_index_enabled", value) &&
+         !value.IsNull() && value.GetValue<bool>();
+}
+
+std::optional<FileIndex> FileIndex::load(ClientContext &ctx,
+                                         const OpenFileInfo &file,
+                                         const block_file &blocks) {
+  auto &fs = FileSystem::GetFileSystem(ctx);
+  auto file_path = indexed_path(fs, file.path);
+  auto path = index_path(ctx, fs, file_path);
+
+  std::string data;
+  try {
+    auto flags = FileOpenFlags::FILE_FLAGS_READ |
+                 FileOpenFlags::FILE_FLAGS_NULL_IF_NOT_EXISTS;
+    auto handle = fs.OpenFile(path, flags);
+    if (!handle)
+      return {};
+
+    data.resize(handle->GetFileSize());
+    handle->Read(data.data(), data.size(), 0);
+  } catch (std::exception &e) {
+    DUCKDB_LOG_DEBUG(ctx, "Unable to read PST index (%s): %s", path, e.what());
+    return {};
+  }
+
+  IndexReader reader(data);
+  char magic[sizeof(INDEX_MAGIC)];
+  uint32_t version, header_crc;
+  uint64_t file_size;
+  int64_t modified;
+  std::string recorded_path;
+  std::vector<char> path_bytes;
+
+  if (!reader.read(magic, sizeof(magic)) ||
+      std::memcmp(magic, INDEX_MAGIC, sizeof(magic)) != 0 ||
+      !reader.read(version) || version != INDEX_VERSION ||
+      !reader.read(path_bytes) || !reader.read(file_size) ||
+      !reader.read(modified) || !reader.read(header_crc))
+    return {};
+
+  // Stale (or someone else's) index
+  recorded_path.assign(path_bytes.begin(), path_bytes.end());
+  if (recorded_path != file_path || file_size != blocks.size() ||
+      modified != blocks.modified() || header_crc != blocks.crc())
+    return {};
+
+  FileIndex index;
+  if (!reader.read(index.folders) || !reader.read(index.messages) ||
+      !reader.read(index.message_classes) ||
+      index.message_classes.size() != index.messages.size())
+    return {};
+
+  return index;
+}
+
+FileIndex FileIndex::build(pstsdk::pst &pst) {
+  FileIndex index;
+
+  for (pstsdk::pst::folder_filter_iterator it = pst.folder_node_begin();
+       it != pst.folder_node_end(); ++it) {
+    index.folders.emplace_back(it->id);
+  }
+
+  MessageClassifier classify(pst);
+  for (pstsdk::pst::message_filter_iterator it = pst.message_node_begin();
+       it != pst.message_node_end(); ++it) {
+    index.messages.emplace_back(it->id);
+    index.message_classes.emplace_back(classify(it->id));
+  }
+
+  return index;
+}
+
+void FileIndex::save(ClientContext &ctx, const OpenFileInfo &file,
+                     const block_file &blocks) const {
+  auto &fs = FileSystem::GetFileSystem(ctx);
+  auto file_path = indexed_path(fs, file.path);
+  auto path = index_path(ctx, fs, file_path);
+
+  std::string data;
+  data.append(INDEX_MAGIC, sizeof(INDEX_MAGIC));
+  write(data, INDEX_VERSION);
+  write(data, std::vector<char>(file_path.begin(), file_path.end()));
+  write(data, blocks.size());
+  write(data, blocks.modified());
+  write(data, blocks.crc());
+  write(data, folders);
+  write(data, messages);
+  write(data, message_classes);
+
+  // Written aside and moved into place, so readers never see half an index.
+  // Several threads (or processes) may index the same file at once, so each
+  // writer gets a temporary file of its own.
+  static const uint64_t writer_id = std::random_device()();
+  static std::atomic<uint64_t> writes{0};
+  auto temp_path = path + "." + std::to_string(writer_id) + "." +
+                   std::to_string(writes++) + ".tmp";
+  try {
+    auto flags = FileOpenFlags::FILE_FLAGS_WRITE |
+                 FileOpenFlags::FILE_FLAGS_FILE_CREATE_NEW;
+    auto handle = fs.OpenFile(temp_path, flags);
+    handle->Write(data.data(), data.size());
+    handle->Sync();
+    handle->Close();
+    fs.MoveFile(temp_path, path);
+  } catch (std::exception &e) {
+    DUCKDB_LOG_DEBUG(ctx, "Unable to write PST index (%s): %s", path,
+                     e.what());
+    try {
+      fs.TryRemoveFile(temp_path);
+    } catch (std::exception &) {
+    }
+  }
+}
+
+} // namespace intellekt::duckpst::pst
@@ -0,0 +1,114 @@
+#ifndef _WIN32
+
+#include "pst/mmap_file.hpp"
+
+#include "duckdb/common/exception.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace intellekt::duckpst::pst {
+using namespace duckdb;
+
+mfile::mfile(pstsdk::byte *data, uint64_t mapped_size, int64_t modified,
+             uint64_t readahead_size, uint64_t gap_threshold)
+    : block_file(), data(data), readahead_size(readahead_size),
+      gap_threshold(gap_threshold) {
+  file_size = mapped_size;
+  modified_time = modified;
+  madvise(data, file_size, MADV_RANDOM);
+
+  if (file_size > HEADER_VERSION_OFFSET + 1) {
+    std::memcpy(&header_crc, data + HEADER_CRC_OFFSET, sizeof(header_crc));
+    unicode = (data[HEADER_VERSION_OFFSET] |
+               (data[HEADER_VERSION_OFFSET + 1] << 8)) >=
+              HEADER_UNICODE_MIN_VERSION;
+  }
+}
+
+mfile::~mfile() { munmap(data, file_size); }
+
+std::shared_ptr<block_file> mfile::open(const std::string &path,
+                                        uint64_t expected_size,
+                                        uint64_t readahead_size,
+                                        uint64_t gap_threshold) {
+  int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+    return nullptr;
+
+  // Only map the file the DuckDB file system opened (and checked access to):
+  // if it was replaced or resized since, read it through DuckDB instead
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0 || !S_ISREG(file_stat.st_mode) ||
+      file_stat.st_size == 0 ||
+      static_cast<uint64_t>(file_stat.st_size) != expected_size) {
+    close(fd);
+    return nullptr;
+  }
+
+  auto file_size = static_cast<uint64_t>(file_stat.st_size);
+  void *mapping = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED)
+    return nullptr;
+
+  return std::make_shared<mfile>(static_cast<pstsdk::byte *>(mapping),
+                                 file_size, file_stat.st_mtime, readahead_size,
+                                 gap_threshold);
+}
+
+void mfile::advise_sequential(uint64_t offset) const {
+  if (readahead_size == 0 || offset + readahead_size <= advised_end.load())
+    return;
+
+  static const uint64_t page_size = sysconf(_SC_PAGESIZE);
+  uint64_t start = offset - (offset % page_size);
+  uint64_t end = std::min(offset + readahead_size, file_size);
+
+  madvise(data + start, end - start, MADV_WILLNEED);
+  advised_end = end;
+}
+
+void mfile::prefetch(const std::vector<BlockRange> &blocks) const {
+  static const uint64_t page_size = sysconf(_SC_PAGESIZE);
+
+  for (auto &block : blocks) {
+    if (block.address >= file_size)
+      continue;
+
+    uint64_t start = block.address - (block.address % page_size);
+    uint64_t end =
+        std::min(block.address + disk_block_size(block.size), file_size);
+    madvise(data + start, end - start, MADV_WILLNEED);
+  }
+}
+
+size_t mfile::read(std::vector<pstsdk::byte> &buffer,
+                   pstsdk::ulonglong offset) const {
+  uint64_t read_size = buffer.size();
+  if (offset > file_size || read_size > file_size - offset)
+    throw IOException("Could not read %d bytes at offset %d of PST file "
+                      "(size %d)",
+                      read_size, offset, file_size);
+
+  auto previous_end = last_end.exchange(offset + read_size);
+  if (offset >= previous_end && offset - previous_end <= gap_threshold)
+    advise_sequential(offset);
+
+  std::memcpy(buffer.data(), data + offset, read_size);
+  return read_size;
+}
+
+size_t mfile::write(const std::vector<pstsdk::byte> &buffer,
+                    pstsdk::ulonglong offset) {
+  throw IOException("PST files are mapped read-only");
+}
+
+} // namespace intellekt::duckpst::pst
+
+#endif
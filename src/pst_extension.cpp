@@ -4,13 +4,64 @@
 
 #include "table_function.hpp"
 #include "pst_extension.hpp"
+#include "pst/block_cache.hpp"
+#include "pst/duckdb_filesystem.hpp"
 #include "duckdb/common/exception.hpp"
 #include "duckdb/function/table_function.hpp"
+#include "duckdb/main/config.hpp"
 
 namespace duckdb {
 using namespace intellekt;
 
+static void SetBlockCacheSize(ClientContext &ctx, SetScope scope,
+                              Value &parameter) {
+  duckpst::pst::BlockCache::instance().set_capacity(
+      parameter.GetValue<idx_t>());
+}
+
 static void LoadInternal(ExtensionLoader &loader) {
+  auto &config = DBConfig::GetConfig(loader.GetDatabaseInstance());
+  config.AddExtensionOption(
+      "pst_block_cache_size",
+      "Memory budget (in bytes) of the block cache shared by PST scans. Set to "
+      "0 to disable it.",
+      LogicalType::UBIGINT,
+      Value::UBIGINT(duckpst::pst::BlockCache::DEFAULT_CAPACITY),
+      SetBlockCacheSize, SetScope::GLOBAL);
+  config.AddExtensionOption(
+      "pst_readahead_size",
+      "Largest readahead (in bytes) of sequential reads of a PST file. Set to "
+      "0 to disable readahead.",
+      LogicalType::UBIGINT,
+      Value::UBIGINT(duckpst::pst::DEFAULT_READAHEAD_SIZE));
+  config.AddExtensionOption(
+      "pst_read_gap_threshold",
+      "Largest gap (in bytes) between two reads of a PST file for them to "
+      "still count as sequential (and be coalesced).",
+      LogicalType::UBIGINT,
+      Value::UBIGINT(duckpst::pst::DEFAULT_READ_GAP_THRESHOLD));
+  config.AddExtensionOption(
+      "pst_mmap",
+      "Memory map local PST files (instead of reading them through the DuckDB "
+      "file system). Truncating a mapped file during a query crashes the "
+      "process (SIGBUS), so disable this for files that may be rewritten.",
+      LogicalType::BOOLEAN, Value::BOOLEAN(true));
+  config.AddExtensionOption(
+      "pst_index_enabled",
+      "Plan PST reads from sidecar indexes (NIDs and message classes), "
+      "writing them on first read.",
+      LogicalType::BOOLEAN, Value::BOOLEAN(false));
+  config.AddExtensionOption(
+      "pst_index_directory",
+      "Directory for PST sidecar indexes (by default they are written next "
+      "to each PST file).",
+      LogicalType::VARCHAR, Value(""));
+  config.AddExtensionOption(
+      "pst_max_open_files",
+      "Files a PST scan keeps open at once (the file being read, and those "
+      "planned ahead of it, may exceed this).",
+      LogicalType::UBIGINT, Value::UBIGINT(duckpst::DEFAULT_MAX_OPEN_FILES));
+
   TableFunction proto("default", {LogicalType::VARCHAR},
                       duckpst::PSTReadFunction);
 
@@ -19,12 +70,19 @@ static void LoadInternal(ExtensionLoader &loader) {
   proto.init_global = duckpst::PSTReadInitGlobal;
   proto.init_local = duckpst::PSTReadInitLocal;
 
-  // Currently only used for basic count(*) pushdown
+  // Partition stats answer count(*), partitions have a single pst_path (for
+  // partitioned aggregates), and batch indexes preserve insertion order
   proto.get_partition_info = duckpst::PSTPartitionInfo;
   proto.get_partition_stats = duckpst::PSTPartitionStats;
+  proto.get_partition_data = duckpst::PSTReadPartitionData;
+
+  // Equality and IN filters on node_id, parent_node_id and pst_path narrow
+  // planning (the scan still applies them to its output)
+  proto.pushdown_complex_filter = duckpst::PSTPushdownComplexFilter;
 
-  // For late materialization support, however we can't prune partitions
-  // without `filter_pushdown=true` and handling row-by-row filters ourselves
+  // For late materialization support: filters on the row ID columns (like
+  // the join back to the top k rows) are pushed into the scan, which only
+  // reads the nodes they let through
   proto.get_virtual_columns = duckpst::PSTVirtualColumns;
   proto.get_row_id_columns = duckpst::PSTRowIDColumns;
 
@@ -32,6 +90,7 @@ static void LoadInternal(ExtensionLoader &loader) {
   proto.dynamic_to_string = duckpst::PSTDynamicToString;
 
   proto.late_materialization = true;
+  proto.filter_pushdown = true;
   proto.projection_pushdown = true;
   proto.named_parameters = duckpst::NAMED_PARAMETERS;
 
@@ -1,4 +1,6 @@
 #include "duckdb/common/exception.hpp"
+#include "column_plan.hpp"
+#include "column_writer.hpp"
 #include "function_state.hpp"
 #include "row_serializer.hpp"
 #include "pstsdk/pst/entryid.h"
@@ -17,1281 +19,774 @@
 #include "pst/typed_bag.hpp"
 #include "table_function.hpp"
 
+#include <algorithm>
+#include <bitset>
 #include <cstdint>
 #include <cstring>
+#include <limits>
+#include <iterator>
 #include <type_traits>
 
 namespace intellekt::duckpst::row_serializer {
 
 template <typename T>
-duckdb::Value from_prop(const LogicalType &t,
-                        pstsdk::const_property_object &bag,
-                        pstsdk::prop_id prop) {
+void write_prop(Vector &vec, idx_t row, pstsdk::const_property_object &bag,
+                pstsdk::prop_id prop) {
   std::optional<T> value = bag.read_prop_if_exists<T>(prop);
-  Value duckdb_value = Value(nullptr);
 
   if (!value.has_value())
-    return duckdb_value;
+    return column_writer::write_null(vec, row);
 
-  if constexpr (std::is_integral_v<T>) {
-    if (t.id() == LogicalTypeId::ENUM) {
-      auto as_u64 = boost::numeric_cast<uint64_t>(*value);
-
-      if (as_u64 >= EnumType::GetSize(t))
-        return duckdb_value;
-
-      duckdb_value = Value::ENUM(boost::numeric_cast<uint64_t>(*value), t);
-    } else if (t.id() == LogicalTypeId::TIMESTAMP_SEC) {
-      time_t unixtime = pstsdk::filetime_to_time_t(*value);
-      duckdb_value = Value::TIMESTAMPSEC(timestamp_sec_t(unixtime));
-    }
-  } else if constexpr (std::is_same_v<T, std::vector<unsigned char>>) {
-    std::string blob({value->begin(), value->end()});
-    duckdb_value = Value::BLOB_RAW(blob);
-  }
-
-  if (!duckdb_value.IsNull())
-    return duckdb_value;
-
-  if constexpr (std::is_same_v<T, std::uint8_t>) {
-    duckdb_value = Value::UTINYINT(*value);
-  } else if constexpr (std::is_same_v<T, std::uint16_t>) {
-    duckdb_value = Value::USMALLINT(*value);
-  } else if constexpr (std::is_same_v<T, std::uint32_t>) {
-    duckdb_value = Value::UINTEGER(*value);
-  } else if constexpr (std::is_same_v<T, std::uint64_t>) {
-    duckdb_value = Value::UBIGINT(*value);
-  } else if constexpr (std::is_same_v<T, unsigned long long>) {
-    duckdb_value = Value::UHUGEINT(*value);
-  } else if constexpr (std::is_same_v<T, std::int8_t>) {
-    duckdb_value = Value::TINYINT(*value);
-  } else if constexpr (std::is_same_v<T, std::int16_t>) {
-    duckdb_value = Value::SMALLINT(*value);
-  } else if constexpr (std::is_same_v<T, std::int32_t>) {
-    duckdb_value = Value::INTEGER(*value);
-  } else if constexpr (std::is_same_v<T, std::int64_t>) {
-    duckdb_value = Value::BIGINT(*value);
-  } else if constexpr (std::is_same_v<T, long long>) {
-    duckdb_value = Value::HUGEINT(*value);
-  } else if constexpr (!std::is_same_v<T, std::vector<unsigned char>>) {
-    duckdb_value = Value(*value);
-  }
-
-  return duckdb_value;
+  column_writer::write_prop_value<T>(vec, row, *value);
 }
 
 template <typename T>
-duckdb::Value from_prop_stream(const LogicalType &t,
-                               pstsdk::const_property_object &bag,
-                               pstsdk::prop_id prop, idx_t read_size_bytes) {
-  Value duckdb_value = Value(nullptr);
+void write_prop_stream(Vector &vec, idx_t row,
+                       pstsdk::const_property_object &bag, pstsdk::prop_id prop,
+                       idx_t read_size_bytes) {
   if (!bag.prop_exists(prop))
-    return duckdb_value;
+    return column_writer::write_null(vec, row);
+
+  auto prop_size = bag.size(prop);
+  if (read_size_bytes == 0 || read_size_bytes > prop_size)
+    read_size_bytes = prop_size;
 
   auto prop_type = bag.get_prop_type(prop);
   auto stream = bag.open_prop_stream(prop);
 
+  // 8-bit strings and binary props are already in their output encoding, so
+  // read them straight into the vector's string heap
+  if (std::is_same_v<T, vector<pstsdk::byte>> ||
+      prop_type == pstsdk::prop_type_string) {
+    auto target = StringVector::EmptyString(vec, read_size_bytes);
+    stream.read(target.GetDataWriteable(), read_size_bytes);
+    idx_t bytes_read = stream.gcount();
+    stream.close();
+
+    return column_writer::write_string_t(
+        vec, row,
+        string_t(target.GetData(), static_cast<uint32_t>(bytes_read)));
+  }
+
+  // UTF-16 has to be converted, so it goes through a per-thread scratch buffer
+  // that keeps its capacity between rows
+  thread_local vector<pstsdk::byte> scratch;
+
   // TODO: shitty force align for wchar, have to do it because some PST writers
   // lie about the type
   if ((read_size_bytes % 2) != 0)
     ++read_size_bytes;
 
-  vector<pstsdk::byte> buf(read_size_bytes);
-  stream.read(reinterpret_cast<char *>(buf.data()), read_size_bytes);
+  scratch.resize(read_size_bytes);
+  stream.read(reinterpret_cast<char *>(scratch.data()), read_size_bytes);
+  idx_t bytes_read = stream.gcount();
   stream.close();
 
-  if constexpr (std::is_same_v<T, std::string>) {
-    if (prop_type == pstsdk::prop_type_string) {
-      duckdb_value = Value(std::string(buf.begin(), buf.end()));
-    } else {
-      duckdb_value = Value(std::string(pstsdk::bytes_to_string(buf)));
-    }
-  } else if constexpr (std::is_same_v<T, vector<pstsdk::byte>>) {
-    duckdb_value = Value::BLOB_RAW(std::string(buf.begin(), buf.end()));
-  }
+  // A short read of odd length is padded to a whole wchar with a zero byte,
+  // not whatever an earlier row left in the scratch buffer
+  scratch.resize(bytes_read + (bytes_read % 2));
+  if (bytes_read % 2 != 0)
+    scratch[bytes_read] = 0;
+
+  column_writer::write_string(vec, row,
+                              std::string(pstsdk::bytes_to_string(scratch)));
+}
 
-  return duckdb_value;
+/**
+ * @brief Is a STRUCT field projected? (no fields means no pushdown happened)
+ */
+inline bool is_projected(const vector<idx_t> &fields, idx_t field) {
+  return fields.empty() ||
+         std::find(fields.begin(), fields.end(), field) != fields.end();
 }
 
 template <>
-duckdb::Value into_struct(PSTReadLocalState &local_state, const LogicalType &t,
-                          pstsdk::attachment attachment) {
+void into_struct(PSTReadLocalState &local_state, const vector<idx_t> &fields,
+                 pstsdk::attachment attachment, Vector &target,
+                 idx_t row_number) {
   auto attachment_prop_bag = attachment.get_property_bag();
-  vector<Value> values(StructType::GetChildCount(t), Value(nullptr));
+  auto &entries = StructVector::GetEntries(target);
+
+  for (idx_t col = 0; col < entries.size(); ++col) {
+    auto &vec = *entries[col];
 
-  for (idx_t col = 0; col < values.size(); ++col) {
-    auto &col_type = StructType::GetChildType(t, col);
+    if (!is_projected(fields, col)) {
+      column_writer::write_null(vec, row_number);
+      continue;
+    }
 
     switch (col) {
     case static_cast<int>(schema::AttachmentProjection::attach_content_id):
-      values[col] = from_prop<std::string>(col_type, attachment_prop_bag,
-                                           PR_ATTACH_CONTENT_ID);
+      write_prop<std::string>(vec, row_number, attachment_prop_bag,
+                              PR_ATTACH_CONTENT_ID);
       break;
     case static_cast<int>(schema::AttachmentProjection::attach_method):
-      values[col] =
-          from_prop<int32_t>(col_type, attachment_prop_bag, PR_ATTACH_METHOD);
+      write_prop<int32_t>(vec, row_number, attachment_prop_bag,
+                          PR_ATTACH_METHOD);
       break;
     case static_cast<int>(schema::AttachmentProjection::filename):
-      values[col] = from_prop<std::string>(col_type, attachment_prop_bag,
-                                           PR_ATTACH_FILENAME_A);
+      write_prop<std::string>(vec, row_number, attachment_prop_bag,
+                              PR_ATTACH_FILENAME_A);
       break;
     case static_cast<int>(schema::AttachmentProjection::mime_type):
-      values[col] = from_prop<std::string>(col_type, attachment_prop_bag,
-                                           PR_ATTACH_MIME_TAG_A);
+      write_prop<std::string>(vec, row_number, attachment_prop_bag,
+                              PR_ATTACH_MIME_TAG_A);
       break;
     case static_cast<int>(schema::AttachmentProjection::size):
-      if (!attachment_prop_bag.prop_exists(PR_ATTACH_DATA_BIN))
+      if (!attachment_prop_bag.prop_exists(PR_ATTACH_DATA_BIN)) {
+        column_writer::write_null(vec, row_number);
         break;
-      values[col] = Value::UBIGINT(attachment.content_size());
+      }
+      column_writer::write_numeric(vec, row_number, attachment.content_size());
       break;
     case static_cast<int>(schema::AttachmentProjection::is_message):
-      if (!attachment_prop_bag.prop_exists(PR_ATTACH_METHOD))
+      if (!attachment_prop_bag.prop_exists(PR_ATTACH_METHOD)) {
+        column_writer::write_null(vec, row_number);
         break;
-      values[col] = Value::BOOLEAN(attachment.is_message());
+      }
+      column_writer::write_numeric(vec, row_number, attachment.is_message());
       break;
     case static_cast<int>(schema::AttachmentProjection::bytes):
       if (!attachment_prop_bag.prop_exists(PR_ATTACH_METHOD) ||
           !attachment_prop_bag.prop_exists(PR_ATTACH_DATA_BIN) ||
           attachment.is_message() || attachment.content_size() <= 0 ||
           !local_state.global_state.bind_data.read_attachment_body()) {
+        column_writer::write_null(vec, row_number);
         break;
       }
-      values[col] = from_prop<std::vector<pstsdk::byte>>(
-          col_type, attachment_prop_bag, PR_ATTACH_DATA_BIN);
+      write_prop<std::vector<pstsdk::byte>>(vec, row_number,
+                                            attachment_prop_bag,
+                                            PR_ATTACH_DATA_BIN);
       break;
     default:
+      column_writer::write_null(vec, row_number);
       break;
     }
   }
-
-  return Value::STRUCT(t, values);
 }
 
 template <>
-duckdb::Value into_struct(PSTReadLocalState &local_state, const LogicalType &t,
-                          pstsdk::recipient recipient) {
+void into_struct(PSTReadLocalState &local_state, const vector<idx_t> &fields,
+                 pstsdk::recipient recipient, Vector &target,
+                 idx_t row_number) {
   auto recipient_prop_bag = recipient.get_property_row();
-  vector<Value> values(StructType::GetChildCount(t), Value(nullptr));
+  auto &entries = StructVector::GetEntries(target);
 
-  for (idx_t col = 0; col < values.size(); ++col) {
-    auto &col_type = StructType::GetChildType(t, col);
+  for (idx_t col = 0; col < entries.size(); ++col) {
+    auto &vec = *entries[col];
+
+    if (!is_projected(fields, col)) {
+      column_writer::write_null(vec, row_number);
+      continue;
+    }
 
     switch (col) {
     case static_cast<int>(schema::RecipientProjection::display_name):
-      values[col] = from_prop<std::string>(col_type, recipient_prop_bag,
-                                           PR_DISPLAY_NAME_A);
+      write_prop<std::string>(vec, row_number, recipient_prop_bag,
+                              PR_DISPLAY_NAME_A);
       break;
     case static_cast<int>(schema::RecipientProjection::account_name):
-      values[col] =
-          from_prop<std::string>(col_type, recipient_prop_bag, PR_ACCOUNT_A);
+      write_prop<std::string>(vec, row_number, recipient_prop_bag,
+                              PR_ACCOUNT_A);
       break;
     case static_cast<int>(schema::RecipientProjection::email_address):
-      values[col] = from_prop<std::string>(col_type, recipient_prop_bag,
-                                           PR_EMAIL_ADDRESS_A);
+      write_prop<std::string>(vec, row_number, recipient_prop_bag,
+                              PR_EMAIL_ADDRESS_A);
       break;
     case static_cast<int>(schema::RecipientProjection::address_type):
-      values[col] =
-          from_prop<std::string>(col_type, recipient_prop_bag, PR_ADDRTYPE_A);
+      write_prop<std::string>(vec, row_number, recipient_prop_bag,
+                              PR_ADDRTYPE_A);
       break;
     case static_cast<int>(schema::RecipientProjection::recipient_type):
-      values[col] =
-          from_prop<int32_t>(col_type, recipient_prop_bag, PR_RECIPIENT_TYPE);
+      write_prop<int32_t>(vec, row_number, recipient_prop_bag,
+                          PR_RECIPIENT_TYPE);
       break;
     case static_cast<int>(schema::RecipientProjection::recipient_type_raw):
-      values[col] =
-          from_prop<int32_t>(col_type, recipient_prop_bag, PR_RECIPIENT_TYPE);
+      write_prop<int32_t>(vec, row_number, recipient_prop_bag,
+                          PR_RECIPIENT_TYPE);
       break;
     default:
+      column_writer::write_null(vec, row_number);
       break;
     }
   }
-  return Value::STRUCT(t, values);
 }
 
-template <>
-void set_output_column(PSTReadLocalState &local_state,
-                       duckdb::DataChunk &output, pstsdk::pst &pst,
-                       idx_t row_number, idx_t column_index) {
-  auto schema_col = local_state.column_ids()[column_index];
-  auto &pst_bag = pst.get_property_bag();
-  auto &col_type =
-      StructType::GetChildType(local_state.output_schema(), schema_col);
-
-  switch (schema_col) {
-  case static_cast<int>(schema::PSTProjection::pst_path):
-    output.SetValue(column_index, row_number,
-                    Value(local_state.partition->file.path));
-    break;
-  case static_cast<int>(schema::PSTProjection::pst_name):
-    output.SetValue(
-        column_index, row_number,
-        from_prop<std::string>(col_type, pst_bag, PR_DISPLAY_NAME_A));
-    break;
-  case static_cast<int>(schema::PSTProjection::record_key):
-    output.SetValue(
-        column_index, row_number,
-        from_prop<std::vector<pstsdk::byte>>(col_type, pst_bag, PR_RECORD_KEY));
-    break;
-  default:
-    break;
+/**
+ * @brief Append pstsdk sub-objects (recipients, attachments) to a LIST of
+ * STRUCT column, writing the struct fields straight into the child vectors
+ */
+template <typename Iterator>
+void write_struct_list(PSTReadLocalState &local_state,
+                       const vector<idx_t> &fields, Iterator begin,
+                       Iterator end, Vector &target, idx_t row_number,
+                       const char *struct_name) {
+  auto offset = ListVector::GetListSize(target);
+  auto &child = ListVector::GetEntry(target);
+  idx_t length = 0;
+
+  for (auto it = begin; it != end; ++it, ++length) {
+    ListVector::Reserve(target, offset + length + 1);
+
+    try {
+      into_struct(local_state, fields, *it, child, offset + length);
+    } catch (std::exception &e) {
+      DUCKDB_LOG_ERROR(local_state.ec, "Unable to serialize %s struct: %s",
+                       struct_name, e.what());
+      column_writer::write_null(child, offset + length);
+    }
   }
+
+  auto &entry = FlatVector::GetData<list_entry_t>(target)[row_number];
+  entry.offset = offset;
+  entry.length = length;
+  ListVector::SetListSize(target, offset + length);
 }
 
-template <>
-void set_output_column(PSTReadLocalState &local_state,
-                       duckdb::DataChunk &output, pstsdk::message &msg,
-                       idx_t row_number, idx_t column_index) {
-  auto &prop_bag = msg.get_property_bag();
-  auto schema_col = local_state.column_ids()[column_index];
-  auto &col_type =
-      StructType::GetChildType(local_state.output_schema(), schema_col);
-  auto read_size = local_state.global_state.bind_data.read_body_size_bytes();
-
-  switch (schema_col) {
-  case static_cast<int>(schema::NoteProjection::display_name):
-    output.SetValue(
-        column_index, row_number,
-        from_prop<std::string>(col_type, prop_bag, PR_DISPLAY_NAME_A));
-    break;
-  case static_cast<int>(schema::NoteProjection::comment):
-    output.SetValue(column_index, row_number,
-                    from_prop<std::string>(col_type, prop_bag, PR_COMMENT_A));
-    break;
-  case static_cast<int>(schema::NoteProjection::creation_time):
-    output.SetValue(
-        column_index, row_number,
-        from_prop<pstsdk::ulonglong>(col_type, prop_bag, PR_CREATION_TIME));
-    break;
-  case static_cast<int>(schema::NoteProjection::last_modified):
-    output.SetValue(column_index, row_number,
-                    from_prop<pstsdk::ulonglong>(col_type, prop_bag,
-                                                 PR_LAST_MODIFICATION_TIME));
-    break;
-  case static_cast<int>(schema::NoteProjection::importance):
-    output.SetValue(column_index, row_number,
-                    from_prop<int32_t>(col_type, prop_bag, PR_IMPORTANCE));
-    break;
-  case static_cast<int>(schema::NoteProjection::priority): {
-    // This can be -1, 0, 1, so we have to do a little extra work
-    auto priority = prop_bag.read_prop_if_exists<int32_t>(PR_PRIORITY);
-    if (priority) {
-      auto enum_idx = *priority + 1;
-      if (enum_idx < EnumType::GetSize(schema::PRIORITY_ENUM)) {
-        output.SetValue(column_index, row_number,
-                        Value::ENUM(enum_idx, schema::PRIORITY_ENUM));
-        return;
-      }
-    }
-    output.SetValue(column_index, row_number, Value(nullptr));
-    break;
-  }
-  case static_cast<int>(schema::NoteProjection::sensitivity):
-    output.SetValue(column_index, row_number,
-                    from_prop<int32_t>(col_type, prop_bag, PR_SENSITIVITY));
-    break;
-  case static_cast<int>(schema::NoteProjection::subject):
-    output.SetValue(column_index, row_number,
-                    from_prop<std::string>(col_type, prop_bag, PR_SUBJECT_A));
-    break;
-  case static_cast<int>(schema::NoteProjection::body):
-    if (!prop_bag.prop_exists(PR_BODY_A)) {
-      output.SetValue(column_index, row_number, Value(nullptr));
-      return;
-    }
-    {
-      auto body_size = prop_bag.size(PR_BODY_A);
-      if (read_size == 0)
-        read_size = prop_bag.size(PR_BODY_A);
-
-      read_size = std::min<idx_t>(read_size, body_size);
-      output.SetValue(column_index, row_number,
-                      from_prop_stream<std::string>(col_type, prop_bag,
-                                                    PR_BODY_A, read_size));
-    }
-    break;
-  case static_cast<int>(schema::NoteProjection::sender_name):
-    output.SetValue(
-        column_index, row_number,
-        from_prop<std::string>(col_type, prop_bag, PR_SENDER_NAME_A));
-    break;
-  case static_cast<int>(schema::NoteProjection::sender_email_address):
-    output.SetValue(
-        column_index, row_number,
-        from_prop<std::string>(col_type, prop_bag, PR_SENDER_EMAIL_ADDRESS_A));
-    break;
-  case static_cast<int>(schema::NoteProjection::message_delivery_time):
-    output.SetValue(column_index, row_number,
-                    from_prop<pstsdk::ulonglong>(col_type, prop_bag,
-                                                 PR_MESSAGE_DELIVERY_TIME));
-    break;
-  case static_cast<int>(schema::NoteProjection::message_class):
-    output.SetValue(
-        column_index, row_number,
-        from_prop<std::string>(col_type, prop_bag, PR_MESSAGE_CLASS_A));
-    break;
-  case static_cast<int>(schema::NoteProjection::message_flags):
-    output.SetValue(column_index, row_number,
-                    from_prop<int32_t>(col_type, prop_bag, PR_MESSAGE_FLAGS));
-    break;
-  case static_cast<int>(schema::NoteProjection::message_size):
-    output.SetValue(column_index, row_number, Value::UBIGINT(msg.size()));
-    break;
-  case static_cast<int>(schema::NoteProjection::has_attachments): {
-    size_t attachment_count = msg.get_attachment_count();
-    output.SetValue(column_index, row_number,
-                    Value::BOOLEAN(attachment_count > 0));
-    break;
-  }
-  case static_cast<int>(schema::NoteProjection::attachment_count): {
-    size_t attachment_count = msg.get_attachment_count();
-    output.SetValue(column_index, row_number, Value::UBIGINT(attachment_count));
-    break;
-  }
-  case static_cast<int>(schema::NoteProjection::body_html):
-    if (!prop_bag.prop_exists(PR_HTML)) {
-      output.SetValue(column_index, row_number, Value(nullptr));
+/* Column readers (one per projected column, chosen in plan_columns) */
+
+template <typename Item>
+void read_null(PSTReadLocalState &local_state, const ColumnReader<Item> &reader,
+               Item &item, Vector &target, idx_t row_number) {
+  column_writer::write_null(target, row_number);
+}
+
+template <typename Item, typename T>
+void read_prop(PSTReadLocalState &local_state, const ColumnReader<Item> &reader,
+               Item &item, Vector &target, idx_t row_number) {
+  write_prop<T>(target, row_number, item.bag(), reader.prop);
+}
+
+template <typename Item, typename T>
+void read_store_prop(PSTReadLocalState &local_state,
+                     const ColumnReader<Item> &reader, Item &item,
+                     Vector &target, idx_t row_number) {
+  write_prop<T>(target, row_number, local_state.pst->get_property_bag(),
+                reader.prop);
+}
+
+template <typename Item>
+void read_node_id(PSTReadLocalState &local_state,
+                  const ColumnReader<Item> &reader, Item &item, Vector &target,
+                  idx_t row_number) {
+  column_writer::write_numeric(target, row_number, item.nid);
+}
+
+template <typename Item>
+void read_parent_node_id(PSTReadLocalState &local_state,
+                         const ColumnReader<Item> &reader, Item &item,
+                         Vector &target, idx_t row_number) {
+  column_writer::write_numeric(target, row_number, item.parent_id());
+}
+
+template <typename Item>
+void read_partition_index(PSTReadLocalState &local_state,
+                          const ColumnReader<Item> &reader, Item &item,
+                          Vector &target, idx_t row_number) {
+  column_writer::write_numeric(target, row_number,
+                               local_state.partition->partition_index);
+}
+
+template <typename Item>
+void read_pst_path(PSTReadLocalState &local_state,
+                   const ColumnReader<Item> &reader, Item &item, Vector &target,
+                   idx_t row_number) {
+  column_writer::write_string(target, row_number,
+                              local_state.partition->file.path);
+}
+
+template <typename Item>
+void read_priority(PSTReadLocalState &local_state,
+                   const ColumnReader<Item> &reader, Item &item, Vector &target,
+                   idx_t row_number) {
+  // This can be -1, 0, 1, so we have to do a little extra work
+  auto priority = item.bag().template read_prop_if_exists<int32_t>(reader.prop);
+  if (priority) {
+    auto enum_idx = *priority + 1;
+    if (enum_idx < EnumType::GetSize(schema::PRIORITY_ENUM)) {
+      column_writer::write_numeric(target, row_number, enum_idx);
       return;
     }
-    {
-      auto body_size = prop_bag.size(PR_HTML);
-      if (read_size == 0)
-        read_size = body_size;
-      read_size = std::min<idx_t>(read_size, body_size);
-      output.SetValue(column_index, row_number,
-                      from_prop_stream<std::string>(col_type, prop_bag, PR_HTML,
-                                                    read_size));
-    }
-    break;
-  case static_cast<int>(schema::NoteProjection::internet_message_id):
-    output.SetValue(
-        column_index, row_number,
-        from_prop<std::string>(col_type, prop_bag, PR_INTERNET_MESSAGE_ID));
-    break;
-  case static_cast<int>(schema::NoteProjection::conversation_topic):
-    output.SetValue(
-        column_index, row_number,
-        from_prop<std::string>(col_type, prop_bag, PR_CONVERSATION_TOPIC_A));
-    break;
-  case static_cast<int>(schema::NoteProjection::recipients): {
-    vector<Value> recipients;
-    for (auto it = msg.recipient_begin(); it != msg.recipient_end(); ++it) {
-      try {
-        recipients.emplace_back(
-            into_struct(local_state, schema::RECIPIENT_SCHEMA, *it));
-      } catch (std::exception &e) {
-        DUCKDB_LOG_ERROR(local_state.ec,
-                         "Unable to serialize recipient struct: %s", e.what());
-        recipients.emplace_back(Value(nullptr));
-      }
-    }
-    output.SetValue(column_index, row_number,
-                    Value::LIST(schema::RECIPIENT_SCHEMA, recipients));
-    break;
   }
-  case static_cast<int>(schema::NoteProjection::attachments): {
-    vector<Value> attachments;
-    for (auto it = msg.attachment_begin(); it != msg.attachment_end(); ++it) {
-      try {
-        attachments.emplace_back(
-            into_struct(local_state, schema::ATTACHMENT_SCHEMA, *it));
-      } catch (std::exception &e) {
-        DUCKDB_LOG_ERROR(local_state.ec,
-                         "Unable to serialize attachment struct: %s", e.what());
-        attachments.emplace_back(Value(nullptr));
-      }
-    }
+  column_writer::write_null(target, row_number);
+}
 
-    output.SetValue(column_index, row_number,
-                    Value::LIST(schema::ATTACHMENT_SCHEMA, attachments));
-    break;
-  }
-  default:
-    break;
-  }
+template <typename Item>
+void read_body(PSTReadLocalState &local_state, const ColumnReader<Item> &reader,
+               Item &item, Vector &target, idx_t row_number) {
+  write_prop_stream<std::string>(
+      target, row_number, item.bag(), reader.prop,
+      local_state.global_state.bind_data.read_body_size_bytes());
 }
 
-template <>
-void set_output_column(PSTReadLocalState &local_state,
-                       duckdb::DataChunk &output,
-                       pst::TypedBag<pst::MessageClass::Contact> &contact,
-                       idx_t row_number, idx_t column_index) {
-  auto &prop_bag = contact.bag;
-  auto schema_col = local_state.column_ids()[column_index];
-  auto &col_type =
-      StructType::GetChildType(local_state.output_schema(), schema_col);
-
-  switch (schema_col) {
-  case static_cast<int>(schema::ContactProjection::account_name):
-    output.SetValue(column_index, row_number,
-                    from_prop<std::string>(col_type, prop_bag, PR_ACCOUNT_A));
-    break;
-  case static_cast<int>(schema::ContactProjection::callback_number):
-    output.SetValue(column_index, row_number,
-                    from_prop<std::string>(col_type, prop_bag,
-                                           PR_CALLBACK_TELEPHONE_NUMBER_A));
-    break;
-  case static_cast<int>(schema::ContactProjection::conversation_prohibited):
-    output.SetValue(
-        column_index, row_number,
-        from_prop<bool>(col_type, prop_bag, PR_CONVERSION_PROHIBITED));
-    break;
-  case static_cast<int>(schema::ContactProjection::disclose_recipients):
-    output.SetValue(
-        column_index, row_number,
-        from_prop<bool>(col_type, prop_bag, PR_DISCLOSE_RECIPIENTS));
-    break;
-  case static_cast<int>(schema::ContactProjection::generation_suffix):
-    output.SetValue(
-        column_index, row_number,
-        from_prop<std::string>(col_type, prop_bag, PR_GENERATION_A));
-    break;
-  case static_cast<int>(schema::ContactProjection::given_name):
-    output.SetValue(
-        column_index, row_number,
-        from_prop<std::string>(col_type, prop_bag, PR_GIVEN_NAME_A));
-    break;
-  case static_cast<int>(schema::ContactProjection::government_id_number):
-    output.SetValue(
-        column_index, row_number,
-        from_prop<std::string>(col_type, prop_bag, PR_GOVERNMENT_ID_NUMBER_A));
-    break;
-  case static_cast<int>(schema::ContactProjection::business_telephone):
-    output.SetValue(column_index, row_number,
-                    from_prop<std::string>(col_type, prop_bag,
-                                           PR_BUSINESS_TELEPHONE_NUMBER_A));
-    break;
-  case static_cast<int>(schema::ContactProjection::home_telephone):
-    output.SetValue(
-        column_index, row_number,
-        from_prop<std::string>(col_type, prop_bag, PR_HOME_TELEPHONE_NUMBER_A));
-    break;
-  case static_cast<int>(schema::ContactProjection::initials):
-    output.SetValue(column_index, row_number,
-                    from_prop<std::string>(col_type, prop_bag, PR_INITIALS_A));
-    break;
-  case static_cast<int>(schema::ContactProjection::keyword):
-    output.SetValue(column_index, row_number,
-                    from_prop<std::string>(col_type, prop_bag, PR_KEYWORD_A));
-    break;
-  case static_cast<int>(schema::ContactProjection::language):
-    output.SetValue(column_index, row_number,
-                    from_prop<std::string>(col_type, prop_bag, PR_LANGUAGE_A));
-    break;
-  case static_cast<int>(schema::ContactProjection::location):
-    output.SetValue(column_index, row_number,
-                    from_prop<std::string>(col_type, prop_bag, PR_LOCATION_A));
-    break;
-  case static_cast<int>(schema::ContactProjection::mail_permission):
-    output.SetValue(column_index, row_number,
-                    from_prop<bool>(col_type, prop_bag, PR_MAIL_PERMISSION));
-    break;
-  case static_cast<int>(schema::ContactProjection::mhs_common_name):
-    output.SetValue(
-        column_index, row_number,
-        from_prop<std::string>(col_type, prop_bag, PR_MHS_COMMON_NAME_A));
-    break;
-  case static_cast<int>(schema::ContactProjection::organizational_id_number):
-    output.SetValue(column_index, row_number,
-                    from_prop<std::string>(col_type, prop_bag,
-                                           PR_ORGANIZATIONAL_ID_NUMBER_A));
-    break;
-  case static_cast<int>(schema::ContactProjection::surname):
-    output.SetValue(column_index, row_number,
-                    from_prop<std::string>(col_type, prop_bag, PR_SURNAME_A));
-    break;
-  case static_cast<int>(schema::ContactProjection::original_display_name):
-    output.SetValue(
-        column_index, row_number,
-        from_prop<std::string>(col_type, prop_bag, PR_ORIGINAL_DISPLAY_NAME_A));
-    break;
-  case static_cast<int>(schema::ContactProjection::postal_address):
-    output.SetValue(
-        column_index, row_number,
-        from_prop<std::string>(col_type, prop_bag, PR_POSTAL_ADDRESS_A));
-    break;
-  case static_cast<int>(schema::ContactProjection::company_name):
-    output.SetValue(
-        column_index, row_number,
-        from_prop<std::string>(col_type, prop_bag, PR_COMPANY_NAME_A));
-    break;
-  case static_cast<int>(schema::ContactProjection::title):
-    output.SetValue(column_index, row_number,
-                    from_prop<std::string>(col_type, prop_bag, PR_TITLE_A));
-    break;
-  case static_cast<int>(schema::ContactProjection::department_name):
-    output.SetValue(
-        column_index, row_number,
-        from_prop<std::string>(col_type, prop_bag, PR_DEPARTMENT_NAME_A));
-    break;
-  case static_cast<int>(schema::ContactProjection::office_location):
-    output.SetValue(
-        column_index, row_number,
-        from_prop<std::string>(col_type, prop_bag, PR_OFFICE_LOCATION_A));
-    break;
-  case static_cast<int>(schema::ContactProjection::primary_telephone):
-    output.SetValue(column_index, row_number,
-                    from_prop<std::string>(col_type, prop_bag,
-                                           PR_PRIMARY_TELEPHONE_NUMBER_A));
-    break;
-  case static_cast<int>(schema::ContactProjection::business_telephone_2):
-    output.SetValue(column_index, row_number,
-                    from_prop<std::string>(col_type, prop_bag,
-                                           PR_BUSINESS2_TELEPHONE_NUMBER_A));
-    break;
-  case static_cast<int>(schema::ContactProjection::mobile_telephone):
-    output.SetValue(column_index, row_number,
-                    from_prop<std::string>(col_type, prop_bag,
-                                           PR_MOBILE_TELEPHONE_NUMBER_A));
-    break;
-  case static_cast<int>(schema::ContactProjection::radio_telephone):
-    output.SetValue(column_index, row_number,
-                    from_prop<std::string>(col_type, prop_bag,
-                                           PR_RADIO_TELEPHONE_NUMBER_A));
-    break;
-  case static_cast<int>(schema::ContactProjection::car_telephone):
-    output.SetValue(
-        column_index, row_number,
-        from_prop<std::string>(col_type, prop_bag, PR_CAR_TELEPHONE_NUMBER_A));
-    break;
-  case static_cast<int>(schema::ContactProjection::other_telephone):
-    output.SetValue(column_index, row_number,
-                    from_prop<std::string>(col_type, prop_bag,
-                                           PR_OTHER_TELEPHONE_NUMBER_A));
-    break;
-  case static_cast<int>(schema::ContactProjection::transmittable_display_name):
-    output.SetValue(column_index, row_number,
-                    from_prop<std::string>(col_type, prop_bag,
-                                           PR_TRANSMITABLE_DISPLAY_NAME_A));
-    break;
-  case static_cast<int>(schema::ContactProjection::pager_telephone):
-    output.SetValue(column_index, row_number,
-                    from_prop<std::string>(col_type, prop_bag,
-                                           PR_PAGER_TELEPHONE_NUMBER_A));
-    break;
-  case static_cast<int>(schema::ContactProjection::primary_fax):
-    output.SetValue(
-        column_index, row_number,
-        from_prop<std::string>(col_type, prop_bag, PR_PRIMARY_FAX_NUMBER_A));
-    break;
-  case static_cast<int>(schema::ContactProjection::business_fax):
-    output.SetValue(
-        column_index, row_number,
-        from_prop<std::string>(col_type, prop_bag, PR_BUSINESS_FAX_NUMBER_A));
-    break;
-  case static_cast<int>(schema::ContactProjection::home_fax):
-    output.SetValue(
-        column_index, row_number,
-        from_prop<std::string>(col_type, prop_bag, PR_HOME_FAX_NUMBER_A));
-    break;
-  case static_cast<int>(schema::ContactProjection::business_address_country):
-    output.SetValue(column_index, row_number,
-                    from_prop<std::string>(col_type, prop_bag, PR_COUNTRY_A));
-    break;
-  case static_cast<int>(schema::ContactProjection::business_address_city):
-    output.SetValue(column_index, row_number,
-                    from_prop<std::string>(col_type, prop_bag, PR_LOCALITY_A));
-    break;
-  case static_cast<int>(schema::ContactProjection::business_address_state):
-    output.SetValue(
-        column_index, row_number,
-        from_prop<std::string>(col_type, prop_bag, PR_STATE_OR_PROVINCE_A));
-    break;
-  case static_cast<int>(schema::ContactProjection::business_address_street):
-    output.SetValue(
-        column_index, row_number,
-        from_prop<std::string>(col_type, prop_bag, PR_STREET_ADDRESS_A));
-    break;
-  case static_cast<int>(schema::ContactProjection::business_postal_code):
-    output.SetValue(
-        column_index, row_number,
-        from_prop<std::string>(col_type, prop_bag, PR_POSTAL_CODE_A));
-    break;
-  case static_cast<int>(schema::ContactProjection::business_po_box):
-    output.SetValue(
-        column_index, row_number,
-        from_prop<std::string>(col_type, prop_bag, PR_POST_OFFICE_BOX_A));
-    break;
-  case static_cast<int>(schema::ContactProjection::telex_number):
-    output.SetValue(
-        column_index, row_number,
-        from_prop<std::string>(col_type, prop_bag, PR_TELEX_NUMBER_A));
-    break;
-  case static_cast<int>(schema::ContactProjection::isdn_number):
-    output.SetValue(
-        column_index, row_number,
-        from_prop<std::string>(col_type, prop_bag, PR_ISDN_NUMBER_A));
-    break;
-  case static_cast<int>(schema::ContactProjection::assistant_telephone):
-    output.SetValue(column_index, row_number,
-                    from_prop<std::string>(col_type, prop_bag,
-                                           PR_ASSISTANT_TELEPHONE_NUMBER_A));
-    break;
-  case static_cast<int>(schema::ContactProjection::home_telephone_2):
-    output.SetValue(column_index, row_number,
-                    from_prop<std::string>(col_type, prop_bag,
-                                           PR_HOME2_TELEPHONE_NUMBER_A));
-    break;
-  case static_cast<int>(schema::ContactProjection::assistant):
-    output.SetValue(column_index, row_number,
-                    from_prop<std::string>(col_type, prop_bag, PR_ASSISTANT_A));
-    break;
-  case static_cast<int>(schema::ContactProjection::send_rich_info):
-    output.SetValue(column_index, row_number,
-                    from_prop<bool>(col_type, prop_bag, PR_SEND_RICH_INFO));
-    break;
-  case static_cast<int>(schema::ContactProjection::wedding_anniversary):
-    output.SetValue(column_index, row_number,
-                    from_prop<pstsdk::ulonglong>(col_type, prop_bag,
-                                                 PR_WEDDING_ANNIVERSARY));
-    break;
-  case static_cast<int>(schema::ContactProjection::birthday):
-    output.SetValue(
-        column_index, row_number,
-        from_prop<pstsdk::ulonglong>(col_type, prop_bag, PR_BIRTHDAY));
-    break;
-  case static_cast<int>(schema::ContactProjection::hobbies):
-    output.SetValue(column_index, row_number,
-                    from_prop<std::string>(col_type, prop_bag, PR_HOBBIES_A));
-    break;
-  case static_cast<int>(schema::ContactProjection::middle_name):
-    output.SetValue(
-        column_index, row_number,
-        from_prop<std::string>(col_type, prop_bag, PR_MIDDLE_NAME_A));
-    break;
-  case static_cast<int>(schema::ContactProjection::display_name_prefix):
-    output.SetValue(
-        column_index, row_number,
-        from_prop<std::string>(col_type, prop_bag, PR_DISPLAY_NAME_PREFIX_A));
-    break;
-  case static_cast<int>(schema::ContactProjection::profession):
-    output.SetValue(
-        column_index, row_number,
-        from_prop<std::string>(col_type, prop_bag, PR_PROFESSION_A));
-    break;
-  case static_cast<int>(schema::ContactProjection::preferred_by_name):
-    output.SetValue(
-        column_index, row_number,
-        from_prop<std::string>(col_type, prop_bag, PR_PREFERRED_BY_NAME_A));
-    break;
-  case static_cast<int>(schema::ContactProjection::spouse_name):
-    output.SetValue(
-        column_index, row_number,
-        from_prop<std::string>(col_type, prop_bag, PR_SPOUSE_NAME_A));
-    break;
-  case static_cast<int>(schema::ContactProjection::computer_network_name):
-    output.SetValue(
-        column_index, row_number,
-        from_prop<std::string>(col_type, prop_bag, PR_COMPUTER_NETWORK_NAME_A));
-    break;
-  case static_cast<int>(schema::ContactProjection::customer_id):
-    output.SetValue(
-        column_index, row_number,
-        from_prop<std::string>(col_type, prop_bag, PR_CUSTOMER_ID_A));
-    break;
-  case static_cast<int>(schema::ContactProjection::ttytdd_phone):
-    output.SetValue(
-        column_index, row_number,
-        from_prop<std::string>(col_type, prop_bag, PR_TTYTDD_PHONE_NUMBER_A));
-    break;
-  case static_cast<int>(schema::ContactProjection::ftp_site):
-    output.SetValue(column_index, row_number,
-                    from_prop<std::string>(col_type, prop_bag, PR_FTP_SITE_A));
-    break;
-  case static_cast<int>(schema::ContactProjection::gender):
-    output.SetValue(column_index, row_number,
-                    from_prop<int16_t>(col_type, prop_bag, PR_GENDER));
-    break;
-  case static_cast<int>(schema::ContactProjection::manager_name):
-    output.SetValue(
-        column_index, row_number,
-        from_prop<std::string>(col_type, prop_bag, PR_MANAGER_NAME_A));
-    break;
-  case static_cast<int>(schema::ContactProjection::nickname):
-    output.SetValue(column_index, row_number,
-                    from_prop<std::string>(col_type, prop_bag, PR_NICKNAME_A));
-    break;
-  case static_cast<int>(schema::ContactProjection::personal_home_page):
-    output.SetValue(
-        column_index, row_number,
-        from_prop<std::string>(col_type, prop_bag, PR_PERSONAL_HOME_PAGE_A));
-    break;
-  case static_cast<int>(schema::ContactProjection::business_home_page):
-    output.SetValue(
-        column_index, row_number,
-        from_prop<std::string>(col_type, prop_bag, PR_BUSINESS_HOME_PAGE_A));
-    break;
-  case static_cast<int>(schema::ContactProjection::company_main_phone):
-    output.SetValue(column_index, row_number,
-                    from_prop<std::string>(col_type, prop_bag,
-                                           PR_COMPANY_MAIN_PHONE_NUMBER_A));
-    break;
-  case static_cast<int>(schema::ContactProjection::childrens_names):
-    output.SetValue(
-        column_index, row_number,
-        from_prop<std::string>(col_type, prop_bag, PR_CHILDRENS_NAMES_A));
-    break;
-  case static_cast<int>(schema::ContactProjection::home_address_city):
-    output.SetValue(
-        column_index, row_number,
-        from_prop<std::string>(col_type, prop_bag, PR_HOME_ADDRESS_CITY_A));
-    break;
-  case static_cast<int>(schema::ContactProjection::home_address_country):
-    output.SetValue(
-        column_index, row_number,
-        from_prop<std::string>(col_type, prop_bag, PR_HOME_ADDRESS_COUNTRY_A));
-    break;
-  case static_cast<int>(schema::ContactProjection::home_address_postal_code):
-    output.SetValue(column_index, row_number,
-                    from_prop<std::string>(col_type, prop_bag,
-                                           PR_HOME_ADDRESS_POSTAL_CODE_A));
-    break;
-  case static_cast<int>(schema::ContactProjection::home_address_state):
-    output.SetValue(
-        column_index, row_number,
-        from_prop<std::string>(col_type, prop_bag,
-                               PR_HOME_ADDRESS_STATE_OR_PROVINCE_A));
-    break;
-  case static_cast<int>(schema::ContactProjection::home_address_street):
-    output.SetValue(
-        column_index, row_number,
-        from_prop<std::string>(col_type, prop_bag, PR_HOME_ADDRESS_STREET_A));
-    break;
-  case static_cast<int>(schema::ContactProjection::home_address_po_box):
-    output.SetValue(column_index, row_number,
-                    from_prop<std::string>(col_type, prop_bag,
-                                           PR_HOME_ADDRESS_POST_OFFICE_BOX_A));
-    break;
-  case static_cast<int>(schema::ContactProjection::other_address_city):
-    output.SetValue(
-        column_index, row_number,
-        from_prop<std::string>(col_type, prop_bag, PR_OTHER_ADDRESS_CITY_A));
-    break;
-  case static_cast<int>(schema::ContactProjection::other_address_country):
-    output.SetValue(
-        column_index, row_number,
-        from_prop<std::string>(col_type, prop_bag, PR_OTHER_ADDRESS_COUNTRY_A));
-    break;
-  case static_cast<int>(schema::ContactProjection::other_address_postal_code):
-    output.SetValue(column_index, row_number,
-                    from_prop<std::string>(col_type, prop_bag,
-                                           PR_OTHER_ADDRESS_POSTAL_CODE_A));
-    break;
-  case static_cast<int>(schema::ContactProjection::other_address_state):
-    output.SetValue(
-        column_index, row_number,
-        from_prop<std::string>(col_type, prop_bag,
-                               PR_OTHER_ADDRESS_STATE_OR_PROVINCE_A));
-    break;
-  case static_cast<int>(schema::ContactProjection::other_address_street):
-    output.SetValue(
-        column_index, row_number,
-        from_prop<std::string>(col_type, prop_bag, PR_OTHER_ADDRESS_STREET_A));
-    break;
-  case static_cast<int>(schema::ContactProjection::other_address_po_box):
-    output.SetValue(column_index, row_number,
-                    from_prop<std::string>(col_type, prop_bag,
-                                           PR_OTHER_ADDRESS_POST_OFFICE_BOX_A));
-    break;
-  default:
-    break;
-  }
+template <typename Item>
+void read_message_size(PSTReadLocalState &local_state,
+                       const ColumnReader<Item> &reader, Item &item,
+                       Vector &target, idx_t row_number) {
+  // Read off the bag (like pstsdk::message::size), which may be a contents
+  // table row
+  auto size = item.bag().template read_prop_if_exists<int32_t>(reader.prop);
+  if (!size)
+    return column_writer::write_null(target, row_number);
+
+  column_writer::write_numeric(target, row_number, static_cast<size_t>(*size));
 }
 
-template <>
-void set_output_column(
-    PSTReadLocalState &local_state, duckdb::DataChunk &output,
-    pst::TypedBag<pst::MessageClass::Appointment> &appointment,
-    idx_t row_number, idx_t column_index) {
-  auto &prop_bag = appointment.bag;
-  auto schema_col = local_state.column_ids()[column_index];
-  auto &col_type =
-      StructType::GetChildType(local_state.output_schema(), schema_col);
-
-  prop_id named_prop_id = 0;
-
-  switch (schema_col) {
-  case static_cast<int>(schema::AppointmentProjection::location):
-    named_prop_id = local_state.pst->lookup_prop_id(pstsdk::ps_appointment,
-                                                    PidLidLocation_A);
-    output.SetValue(column_index, row_number,
-                    from_prop<std::string>(col_type, prop_bag, named_prop_id));
-    break;
-  case static_cast<int>(schema::AppointmentProjection::start_time):
-    named_prop_id = local_state.pst->lookup_prop_id(
-        pstsdk::ps_appointment, PidLidAppointmentStartWhole);
-    output.SetValue(
-        column_index, row_number,
-        from_prop<pstsdk::ulonglong>(col_type, prop_bag, named_prop_id));
-    break;
-  case static_cast<int>(schema::AppointmentProjection::end_time):
-    named_prop_id = local_state.pst->lookup_prop_id(pstsdk::ps_appointment,
-                                                    PidLidAppointmentEndWhole);
-    output.SetValue(
-        column_index, row_number,
-        from_prop<pstsdk::ulonglong>(col_type, prop_bag, named_prop_id));
-    break;
-  case static_cast<int>(schema::AppointmentProjection::duration):
-    named_prop_id = local_state.pst->lookup_prop_id(pstsdk::ps_appointment,
-                                                    PidLidAppointmentDuration);
-    output.SetValue(column_index, row_number,
-                    from_prop<int32_t>(col_type, prop_bag, named_prop_id));
-    break;
-  case static_cast<int>(schema::AppointmentProjection::all_day_event):
-    named_prop_id = local_state.pst->lookup_prop_id(pstsdk::ps_appointment,
-                                                    PidLidAppointmentSubType);
-    output.SetValue(column_index, row_number,
-                    from_prop<bool>(col_type, prop_bag, named_prop_id));
-    break;
-  case static_cast<int>(schema::AppointmentProjection::busy_status):
-    named_prop_id = local_state.pst->lookup_prop_id(pstsdk::ps_appointment,
-                                                    PidLidBusyStatus);
-    output.SetValue(column_index, row_number,
-                    from_prop<int32_t>(col_type, prop_bag, named_prop_id));
-    break;
-  case static_cast<int>(schema::AppointmentProjection::meeting_workspace_url):
-    named_prop_id = local_state.pst->lookup_prop_id(
-        pstsdk::ps_appointment, PidLidMeetingWorkspaceUrl_A);
-    output.SetValue(column_index, row_number,
-                    from_prop<std::string>(col_type, prop_bag, named_prop_id));
-    break;
-  case static_cast<int>(schema::AppointmentProjection::organizer_name):
-    named_prop_id = local_state.pst->lookup_prop_id(pstsdk::ps_appointment,
-                                                    PidLidOwnerName_A);
-    output.SetValue(column_index, row_number,
-                    from_prop<std::string>(col_type, prop_bag, named_prop_id));
-    break;
-  case static_cast<int>(schema::AppointmentProjection::required_attendees):
-    named_prop_id = local_state.pst->lookup_prop_id(pstsdk::ps_appointment,
-                                                    PidLidToAttendeesString_A);
-    output.SetValue(column_index, row_number,
-                    from_prop<std::string>(col_type, prop_bag, named_prop_id));
-    break;
-  case static_cast<int>(schema::AppointmentProjection::optional_attendees):
-    named_prop_id = local_state.pst->lookup_prop_id(pstsdk::ps_appointment,
-                                                    PidLidCcAttendeesString_A);
-    output.SetValue(column_index, row_number,
-                    from_prop<std::string>(col_type, prop_bag, named_prop_id));
-    break;
-  case static_cast<int>(schema::AppointmentProjection::is_recurring):
-    named_prop_id = local_state.pst->lookup_prop_id(pstsdk::ps_appointment,
-                                                    PidLidRecurring);
-    output.SetValue(column_index, row_number,
-                    from_prop<bool>(col_type, prop_bag, named_prop_id));
-    break;
-  case static_cast<int>(schema::AppointmentProjection::recurrence_pattern):
-    named_prop_id = local_state.pst->lookup_prop_id(pstsdk::ps_appointment,
-                                                    PidLidRecurrencePattern_A);
-    output.SetValue(column_index, row_number,
-                    from_prop<std::string>(col_type, prop_bag, named_prop_id));
-    break;
-  case static_cast<int>(schema::AppointmentProjection::is_private): {
-    // Using PR_SENSITIVITY to determine if private (2 = PRIVATE, 3 =
-    // CONFIDENTIAL)
-    auto sensitivity =
-        from_prop<int32_t>(LogicalType::INTEGER, prop_bag, PR_SENSITIVITY);
-    if (!sensitivity.IsNull()) {
-      auto val = sensitivity.GetValue<int32_t>();
-      output.SetValue(column_index, row_number, Value::BOOLEAN(val >= 2));
-    } else {
-      output.SetValue(column_index, row_number, Value(nullptr));
-    }
-    break;
-  }
-  case static_cast<int>(schema::AppointmentProjection::response_status):
-    named_prop_id = local_state.pst->lookup_prop_id(pstsdk::ps_appointment,
-                                                    PidLidResponseStatus);
-    output.SetValue(column_index, row_number,
-                    from_prop<int32_t>(col_type, prop_bag, named_prop_id));
-    break;
-  case static_cast<int>(schema::AppointmentProjection::is_meeting):
-    named_prop_id =
-        local_state.pst->lookup_prop_id(pstsdk::ps_appointment, PidLidFInvited);
-    output.SetValue(column_index, row_number,
-                    from_prop<bool>(col_type, prop_bag, named_prop_id));
-    break;
-  default:
-    break;
-  }
+template <typename Item>
+void read_has_attachments(PSTReadLocalState &local_state,
+                          const ColumnReader<Item> &reader, Item &item,
+                          Vector &target, idx_t row_number) {
+  size_t attachment_count = item.sdk_object().get_attachment_count();
+  column_writer::write_numeric(target, row_number, attachment_count > 0);
 }
 
-template <>
-void set_output_column(
-    PSTReadLocalState &local_state, duckdb::DataChunk &output,
-    pst::TypedBag<pst::MessageClass::StickyNote> &sticky_note, idx_t row_number,
-    idx_t column_index) {
-  auto &prop_bag = sticky_note.bag;
-  auto schema_col = local_state.column_ids()[column_index];
-  auto &col_type =
-      StructType::GetChildType(local_state.output_schema(), schema_col);
-
-  prop_id named_prop_id = 0;
-
-  switch (schema_col) {
-  case static_cast<int>(schema::StickyNoteProjection::note_color):
-    named_prop_id =
-        local_state.pst->lookup_prop_id(pstsdk::ps_note, PidLidNoteColor);
-    output.SetValue(column_index, row_number,
-                    from_prop<int32_t>(col_type, prop_bag, named_prop_id));
-    break;
-  case static_cast<int>(schema::StickyNoteProjection::note_width):
-    named_prop_id =
-        local_state.pst->lookup_prop_id(pstsdk::ps_note, PidLidNoteWidth);
-    output.SetValue(column_index, row_number,
-                    from_prop<int32_t>(col_type, prop_bag, named_prop_id));
-    break;
-  case static_cast<int>(schema::StickyNoteProjection::note_height):
-    named_prop_id =
-        local_state.pst->lookup_prop_id(pstsdk::ps_note, PidLidNoteHeight);
-    output.SetValue(column_index, row_number,
-                    from_prop<int32_t>(col_type, prop_bag, named_prop_id));
-    break;
-  case static_cast<int>(schema::StickyNoteProjection::note_x):
-    named_prop_id =
-        local_state.pst->lookup_prop_id(pstsdk::ps_note, PidLidNoteX);
-    output.SetValue(column_index, row_number,
-                    from_prop<int32_t>(col_type, prop_bag, named_prop_id));
-    break;
-  case static_cast<int>(schema::StickyNoteProjection::note_y):
-    named_prop_id =
-        local_state.pst->lookup_prop_id(pstsdk::ps_note, PidLidNoteY);
-    output.SetValue(column_index, row_number,
-                    from_prop<int32_t>(col_type, prop_bag, named_prop_id));
-    break;
-  default:
-    break;
-  }
+template <typename Item>
+void read_attachment_count(PSTReadLocalState &local_state,
+                           const ColumnReader<Item> &reader, Item &item,
+                           Vector &target, idx_t row_number) {
+  size_t attachment_count = item.sdk_object().get_attachment_count();
+  column_writer::write_numeric(target, row_number, attachment_count);
 }
 
-template <>
-void set_output_column(PSTReadLocalState &local_state,
-                       duckdb::DataChunk &output,
-                       pst::TypedBag<pst::MessageClass::Task> &task,
-                       idx_t row_number, idx_t column_index) {
-  auto &prop_bag = task.bag;
-  auto schema_col = local_state.column_ids()[column_index];
-  auto &col_type =
-      StructType::GetChildType(local_state.output_schema(), schema_col);
-
-  prop_id named_prop_id = 0;
-
-  switch (schema_col) {
-  case static_cast<int>(schema::TaskProjection::task_status):
-    named_prop_id =
-        local_state.pst->lookup_prop_id(pstsdk::ps_task, PidLidTaskStatus);
-    output.SetValue(column_index, row_number,
-                    from_prop<int32_t>(col_type, prop_bag, named_prop_id));
-    break;
-  case static_cast<int>(schema::TaskProjection::percent_complete):
-    named_prop_id =
-        local_state.pst->lookup_prop_id(pstsdk::ps_task, PidLidPercentComplete);
-    output.SetValue(column_index, row_number,
-                    from_prop<double>(col_type, prop_bag, named_prop_id));
-    break;
-  case static_cast<int>(schema::TaskProjection::is_team_task):
-    named_prop_id =
-        local_state.pst->lookup_prop_id(pstsdk::ps_task, PidLidTeamTask);
-    output.SetValue(column_index, row_number,
-                    from_prop<bool>(col_type, prop_bag, named_prop_id));
-    break;
-  case static_cast<int>(schema::TaskProjection::start_date):
-    named_prop_id =
-        local_state.pst->lookup_prop_id(pstsdk::ps_task, PidLidTaskStartDate);
-    output.SetValue(
-        column_index, row_number,
-        from_prop<pstsdk::ulonglong>(col_type, prop_bag, named_prop_id));
-    break;
-  case static_cast<int>(schema::TaskProjection::due_date):
-    named_prop_id =
-        local_state.pst->lookup_prop_id(pstsdk::ps_task, PidLidTaskDueDate);
-    output.SetValue(
-        column_index, row_number,
-        from_prop<pstsdk::ulonglong>(col_type, prop_bag, named_prop_id));
-    break;
-  case static_cast<int>(schema::TaskProjection::date_completed):
-    named_prop_id = local_state.pst->lookup_prop_id(pstsdk::ps_task,
-                                                    PidLidTaskDateCompleted);
-    output.SetValue(
-        column_index, row_number,
-        from_prop<pstsdk::ulonglong>(col_type, prop_bag, named_prop_id));
-    break;
-  case static_cast<int>(schema::TaskProjection::actual_effort):
-    named_prop_id = local_state.pst->lookup_prop_id(pstsdk::ps_task,
-                                                    PidLidTaskActualEffort);
-    output.SetValue(column_index, row_number,
-                    from_prop<int32_t>(col_type, prop_bag, named_prop_id));
-    break;
-  case static_cast<int>(schema::TaskProjection::estimated_effort):
-    named_prop_id = local_state.pst->lookup_prop_id(pstsdk::ps_task,
-                                                    PidLidTaskEstimatedEffort);
-    output.SetValue(column_index, row_number,
-                    from_prop<int32_t>(col_type, prop_bag, named_prop_id));
-    break;
-  case static_cast<int>(schema::TaskProjection::is_complete):
-    named_prop_id =
-        local_state.pst->lookup_prop_id(pstsdk::ps_task, PidLidTaskComplete);
-    output.SetValue(column_index, row_number,
-                    from_prop<bool>(col_type, prop_bag, named_prop_id));
-    break;
-  case static_cast<int>(schema::TaskProjection::task_owner):
-    named_prop_id =
-        local_state.pst->lookup_prop_id(pstsdk::ps_task, PidLidTaskOwner_A);
-    output.SetValue(column_index, row_number,
-                    from_prop<std::string>(col_type, prop_bag, named_prop_id));
-    break;
-  case static_cast<int>(schema::TaskProjection::task_assigner):
-    named_prop_id =
-        local_state.pst->lookup_prop_id(pstsdk::ps_task, PidLidTaskAssigner_A);
-    output.SetValue(column_index, row_number,
-                    from_prop<std::string>(col_type, prop_bag, named_prop_id));
-    break;
-  case static_cast<int>(schema::TaskProjection::last_user):
-    named_prop_id =
-        local_state.pst->lookup_prop_id(pstsdk::ps_task, PidLidTaskLastUser_A);
-    output.SetValue(column_index, row_number,
-                    from_prop<std::string>(col_type, prop_bag, named_prop_id));
-    break;
-  case static_cast<int>(schema::TaskProjection::is_recurring):
-    named_prop_id =
-        local_state.pst->lookup_prop_id(pstsdk::ps_task, PidLidTaskFRecurring);
-    output.SetValue(column_index, row_number,
-                    from_prop<bool>(col_type, prop_bag, named_prop_id));
-    break;
-  case static_cast<int>(schema::TaskProjection::ownership):
-    named_prop_id =
-        local_state.pst->lookup_prop_id(pstsdk::ps_task, PidLidTaskOwnership);
-    output.SetValue(column_index, row_number,
-                    from_prop<int32_t>(col_type, prop_bag, named_prop_id));
-    break;
-  case static_cast<int>(schema::TaskProjection::last_update):
-    named_prop_id =
-        local_state.pst->lookup_prop_id(pstsdk::ps_task, PidLidTaskLastUpdate);
-    output.SetValue(
-        column_index, row_number,
-        from_prop<pstsdk::ulonglong>(col_type, prop_bag, named_prop_id));
-    break;
-  default:
-    break;
-  }
+template <typename Item>
+void read_recipients(PSTReadLocalState &local_state,
+                     const ColumnReader<Item> &reader, Item &item,
+                     Vector &target, idx_t row_number) {
+  auto &msg = item.sdk_object();
+  write_struct_list(local_state, reader.struct_fields, msg.recipient_begin(),
+                    msg.recipient_end(), target, row_number, "recipient");
 }
 
-template <>
-void set_output_column(
-    PSTReadLocalState &local_state, duckdb::DataChunk &output,
-    pst::TypedBag<pst::MessageClass::Note, pstsdk::folder> &folder,
-    idx_t row_number, idx_t column_index) {
-  auto &prop_bag = folder.bag;
-  auto schema_col = local_state.column_ids()[column_index];
-  auto &col_type =
-      StructType::GetChildType(local_state.output_schema(), schema_col);
-
-  switch (schema_col) {
-  case static_cast<int>(schema::FolderProjection::container_class):
-    output.SetValue(
-        column_index, row_number,
-        from_prop<std::string>(col_type, prop_bag, PR_CONTAINER_CLASS_A));
-    break;
-  case static_cast<int>(schema::FolderProjection::display_name):
-    output.SetValue(
-        column_index, row_number,
-        from_prop<std::string>(col_type, prop_bag, PR_DISPLAY_NAME_A));
-    break;
-  case static_cast<int>(schema::FolderProjection::subfolder_count):
-    output.SetValue(column_index, row_number,
-                    Value::UINTEGER(folder.sdk_object->get_subfolder_count()));
-    break;
-  case static_cast<int>(schema::FolderProjection::message_count):
-    output.SetValue(column_index, row_number,
-                    Value::BIGINT(folder.sdk_object->get_message_count()));
-    break;
-  case static_cast<int>(schema::FolderProjection::unread_message_count):
-    output.SetValue(
-        column_index, row_number,
-        Value::BIGINT(folder.sdk_object->get_unread_message_count()));
-    break;
-  default:
-    break;
+template <typename Item>
+void read_attachments(PSTReadLocalState &local_state,
+                      const ColumnReader<Item> &reader, Item &item,
+                      Vector &target, idx_t row_number) {
+  auto &msg = item.sdk_object();
+  write_struct_list(local_state, reader.struct_fields, msg.attachment_begin(),
+                    msg.attachment_end(), target, row_number, "attachment");
+}
+
+template <typename Item>
+void read_is_private(PSTReadLocalState &local_state,
+                     const ColumnReader<Item> &reader, Item &item,
+                     Vector &target, idx_t row_number) {
+  // Using PR_SENSITIVITY to determine if private (2 = PRIVATE, 3 =
+  // CONFIDENTIAL)
+  auto sensitivity =
+      item.bag().template read_prop_if_exists<int32_t>(reader.prop);
+  if (sensitivity) {
+    column_writer::write_numeric(target, row_number, *sensitivity >= 2);
+  } else {
+    column_writer::write_null(target, row_number);
   }
 }
 
-template <>
-void set_output_column(PSTReadLocalState &local_state,
-                       duckdb::DataChunk &output,
-                       pst::TypedBag<pst::MessageClass::DistList> &dlist,
-                       idx_t row_number, idx_t column_index) {
-  auto &prop_bag = dlist.bag;
-  auto schema_col = local_state.column_ids()[column_index];
-  auto &col_type =
-      StructType::GetChildType(local_state.output_schema(), schema_col);
-
-  prop_id named_prop_id = 0;
-  switch (schema_col) {
-  case static_cast<int>(schema::DistributionListProjection::one_off_members): {
-    named_prop_id = local_state.pst->lookup_prop_id(
-        pstsdk::ps_address, PidLidDistributionListOneOffMembers);
-
-    if (!prop_bag.prop_exists(named_prop_id)) {
-      output.SetValue(column_index, row_number, Value(nullptr));
-      break;
-    }
+template <typename Item>
+void read_subfolder_count(PSTReadLocalState &local_state,
+                          const ColumnReader<Item> &reader, Item &item,
+                          Vector &target, idx_t row_number) {
+  column_writer::write_numeric(target, row_number,
+                               item.sdk_object().get_subfolder_count());
+}
 
-    auto entry_ids =
-        prop_bag.read_prop_array<std::vector<pstsdk::byte>>(named_prop_id);
-    vector<Value> oneoff_recipients;
-    for (auto &entry : entry_ids) {
-      auto header = reinterpret_cast<pstsdk::recipient_oneoff_entry_id *>(
-          &entry.data()[0]);
-      if (!pstsdk::guid_eq(header->provider_uid,
-                           pstsdk::provider_uid_recipient_oneoff)) {
-        throw InvalidInputException(
-            "Unknown DistributionList entry ProviderUID, only One-Off entries "
-            "are supported for this property");
-      }
+template <typename Item>
+void read_message_count(PSTReadLocalState &local_state,
+                        const ColumnReader<Item> &reader, Item &item,
+                        Vector &target, idx_t row_number) {
+  column_writer::write_numeric(target, row_number,
+                               item.sdk_object().get_message_count());
+}
 
-      vector<Value> one_off_recipient;
-      for (auto &s : header->read_strings()) {
-        one_off_recipient.emplace_back(Value(s));
-      }
+template <typename Item>
+void read_unread_message_count(PSTReadLocalState &local_state,
+                               const ColumnReader<Item> &reader, Item &item,
+                               Vector &target, idx_t row_number) {
+  column_writer::write_numeric(target, row_number,
+                               item.sdk_object().get_unread_message_count());
+}
 
-      oneoff_recipients.emplace_back(
-          Value::STRUCT(schema::ONE_OFF_RECIPIENT_SCHEMA, one_off_recipient));
+template <typename Item>
+void read_one_off_members(PSTReadLocalState &local_state,
+                          const ColumnReader<Item> &reader, Item &item,
+                          Vector &target, idx_t row_number) {
+  if (!item.bag().prop_exists(reader.prop))
+    return column_writer::write_null(target, row_number);
+
+  auto entry_ids =
+      item.bag().template read_prop_array<std::vector<pstsdk::byte>>(
+          reader.prop);
+
+  auto offset = ListVector::GetListSize(target);
+  ListVector::Reserve(target, offset + entry_ids.size());
+  auto &fields = StructVector::GetEntries(ListVector::GetEntry(target));
+
+  idx_t length = 0;
+  for (auto &entry : entry_ids) {
+    auto header = reinterpret_cast<pstsdk::recipient_oneoff_entry_id *>(
+        &entry.data()[0]);
+    if (!pstsdk::guid_eq(header->provider_uid,
+                         pstsdk::provider_uid_recipient_oneoff)) {
+      throw InvalidInputException(
+          "Unknown DistributionList entry ProviderUID, only One-Off entries "
+          "are supported for this property");
     }
 
-    output.SetValue(
-        column_index, row_number,
-        Value::LIST(schema::ONE_OFF_RECIPIENT_SCHEMA, oneoff_recipients));
-    break;
+    // The strings are in field order (display name, address type, email)
+    auto strings = header->read_strings();
+    for (idx_t field = 0; field < fields.size(); ++field) {
+      if (field < strings.size())
+        column_writer::write_string(*fields[field], offset + length,
+                                    strings[field]);
+      else
+        column_writer::write_null(*fields[field], offset + length);
+    }
+    ++length;
   }
-  case static_cast<int>(schema::DistributionListProjection::member_node_ids): {
-    named_prop_id = local_state.pst->lookup_prop_id(
-        pstsdk::ps_address, PidLidDistributionListMembers);
 
-    if (!prop_bag.prop_exists(named_prop_id)) {
-      output.SetValue(column_index, row_number, Value(nullptr));
-      break;
+  auto &list = FlatVector::GetData<list_entry_t>(target)[row_number];
+  list.offset = offset;
+  list.length = length;
+  ListVector::SetListSize(target, offset + length);
+}
+
+template <typename Item>
+void read_member_node_ids(PSTReadLocalState &local_state,
+                          const ColumnReader<Item> &reader, Item &item,
+                          Vector &target, idx_t row_number) {
+  if (!item.bag().prop_exists(reader.prop))
+    return column_writer::write_null(target, row_number);
+
+  auto entry_ids =
+      item.bag().template read_prop_array<std::vector<pstsdk::byte>>(
+          reader.prop);
+
+  auto offset = ListVector::GetListSize(target);
+  ListVector::Reserve(target, offset + entry_ids.size());
+  auto &contact_nids = ListVector::GetEntry(target);
+  idx_t length = 0;
+
+  for (auto &entry : entry_ids) {
+    auto header =
+        reinterpret_cast<pstsdk::distribution_list_wrapped_entry_id *>(
+            &entry.data()[0]);
+
+    if (!pstsdk::guid_eq(header->provider_uid,
+                         pstsdk::provider_uid_wrapped_entry_id)) {
+      throw InvalidInputException(
+          "Unknown DistributionList entry ProviderUID, only WrappedEntryId "
+          "supported");
     }
 
-    auto entry_ids =
-        prop_bag.read_prop_array<std::vector<pstsdk::byte>>(named_prop_id);
-    vector<duckdb::Value> contact_nids;
+    if (header->get_type() !=
+        pstsdk::distribution_list_entry_id_type::contact) {
+      throw InvalidInputException("Only contact entries are supported");
+    }
 
-    for (auto &entry : entry_ids) {
-      auto header =
-          reinterpret_cast<pstsdk::distribution_list_wrapped_entry_id *>(
-              &entry.data()[0]);
+    // TODO: In a PST file, this is the standard 24 byte entry ID format (last
+    // 4 bytes nid) but it could be a "Message EntryID Structure" which is
+    // different
+    // https://learn.microsoft.com/en-us/openspecs/exchange_server_protocols/ms-oxocntc/02656215-1cb0-4b06-a077-b07e756216be
+    pstsdk::node_id contact_nid;
+    memcpy(&contact_nid, &header->data[20], sizeof(pstsdk::node_id));
+    column_writer::write_numeric(contact_nids, offset + length++,
+                                 contact_nid);
+  }
 
-      if (!pstsdk::guid_eq(header->provider_uid,
-                           pstsdk::provider_uid_wrapped_entry_id)) {
-        throw InvalidInputException(
-            "Unknown DistributionList entry ProviderUID, only WrappedEntryId "
-            "supported");
-      }
+  auto &list = FlatVector::GetData<list_entry_t>(target)[row_number];
+  list.offset = offset;
+  list.length = length;
+  ListVector::SetListSize(target, offset + length);
+}
 
-      if (header->get_type() !=
-          pstsdk::distribution_list_entry_id_type::contact) {
-        throw InvalidInputException("Only contact entries are supported");
-      }
+/**
+ * @brief The prop IDs present on a bag, as a bitmap over the 16-bit prop ID
+ * space (only the bits that were set are cleared between rows)
+ */
+class PropSet {
+  std::bitset<std::numeric_limits<pstsdk::prop_id>::max() + 1> bits;
+  std::vector<pstsdk::prop_id> props;
+
+public:
+  void assign(std::vector<pstsdk::prop_id> &&prop_list) {
+    for (auto prop : props)
+      bits.reset(prop);
+
+    props = std::move(prop_list);
+    for (auto prop : props)
+      bits.set(prop);
+  }
 
-      // TODO: In a PST file, this is the standard 24 byte entry ID format (last
-      // 4 bytes nid) but it could be a "Message EntryID Structure" which is
-      // different
-      // https://learn.microsoft.com/en-us/openspecs/exchange_server_protocols/ms-oxocntc/02656215-1cb0-4b06-a077-b07e756216be
-      pstsdk::node_id contact_nid;
-      memcpy(&contact_nid, &header->data[20], sizeof(pstsdk::node_id));
-      contact_nids.emplace_back(Value::UINTEGER(contact_nid));
-    }
+  bool contains(pstsdk::prop_id prop) const { return bits.test(prop); }
+};
 
-    output.SetValue(column_index, row_number, Value::LIST(contact_nids));
-    break;
-  }
+// Listing a bag walks its whole BTH, which only pays off over individual
+// lookups once enough of the projected columns are props on the bag
+static constexpr idx_t PROP_LIST_MIN_COLUMNS = 8;
+
+// Props that folder contents tables usually have columns for (MS-PST
+// 2.4.4.5.1, plus the sender, which Outlook adds). Scans projecting only
+// these (and columns that don't need the node) read contents tables.
+static constexpr pstsdk::prop_id CONTENTS_TABLE_PROPS[] = {
+    PR_SUBJECT_A, PR_SENDER_NAME_A, PR_IMPORTANCE, PR_PRIORITY, PR_SENSITIVITY,
+    PR_MESSAGE_DELIVERY_TIME, PR_LAST_MODIFICATION_TIME, PR_MESSAGE_CLASS_A,
+    PR_MESSAGE_FLAGS, PR_MESSAGE_SIZE, PR_CONVERSATION_TOPIC_A};
+
+/**
+ * @brief Can a column be read off a message's contents table row?
+ */
+template <typename Item>
+bool in_contents_table(const ColumnDescriptor<Item> &descriptor) {
+  switch (descriptor.source) {
+  case PropSource::Store:
+    return true;
+  case PropSource::Bag:
+    return std::find(std::begin(CONTENTS_TABLE_PROPS),
+                     std::end(CONTENTS_TABLE_PROPS),
+                     descriptor.prop) != std::end(CONTENTS_TABLE_PROPS);
+  case PropSource::Computed:
+    return descriptor.read == read_null<Item> ||
+           descriptor.read == read_node_id<Item> ||
+           descriptor.read == read_parent_node_id<Item> ||
+           descriptor.read == read_partition_index<Item> ||
+           descriptor.read == read_pst_path<Item>;
   default:
-    break;
+    return false;
   }
 }
 
+/* Column descriptor tables (generated from the schema x-macros) */
+
+#define BAG_PROP(T, prop)                                                      \
+  {PropSource::Bag, read_prop<Item, T>, prop, nullptr, 0}
+#define STORE_PROP(T, prop)                                                    \
+  {PropSource::Store, read_store_prop<Item, T>, prop, nullptr, 0}
+#define NAMED_PROP(T, guid, lid)                                               \
+  {PropSource::Named, read_prop<Item, T>, 0, &guid, lid}
+#define COMPUTED(reader) {PropSource::Computed, reader<Item>, 0, nullptr, 0}
+#define COMPUTED_PROP(reader, prop)                                            \
+  {PropSource::Bag, reader<Item>, prop, nullptr, 0}
+#define COMPUTED_NAMED_PROP(reader, guid, lid)                                 \
+  {PropSource::Named, reader<Item>, 0, &guid, lid}
+
+#define COLUMN_DESCRIPTOR(name, type, source) source,
+
+template <typename Item>
+inline constexpr ColumnDescriptor<Item> NOTE_COLUMNS[] = {
+    PST_CHILDREN(COLUMN_DESCRIPTOR) NOTE_CHILDREN(COLUMN_DESCRIPTOR)};
+
 template <typename Item>
-void into_row(PSTReadLocalState &local_state, duckdb::DataChunk &output,
-              Item &item, idx_t row_number) {
-  for (idx_t col_idx = 0; col_idx < local_state.column_ids().size();
-       ++col_idx) {
-    auto schema_col = local_state.column_ids()[col_idx];
-
-    // Bind virtual columns + node_ids (should be 'infallible' as long as the
-    // file isn't borked)
+inline constexpr ColumnDescriptor<Item> CONTACT_COLUMNS[] = {
+    PST_CHILDREN(COLUMN_DESCRIPTOR) NOTE_CHILDREN(COLUMN_DESCRIPTOR)
+        CONTACT_CHILDREN(COLUMN_DESCRIPTOR)};
+
+template <typename Item>
+inline constexpr ColumnDescriptor<Item> APPOINTMENT_COLUMNS[] = {
+    PST_CHILDREN(COLUMN_DESCRIPTOR) NOTE_CHILDREN(COLUMN_DESCRIPTOR)
+        APPOINTMENT_CHILDREN(COLUMN_DESCRIPTOR)};
+
+template <typename Item>
+inline constexpr ColumnDescriptor<Item> STICKY_NOTE_COLUMNS[] = {
+    PST_CHILDREN(COLUMN_DESCRIPTOR) NOTE_CHILDREN(COLUMN_DESCRIPTOR)
+        STICKY_NOTE_CHILDREN(COLUMN_DESCRIPTOR)};
+
+template <typename Item>
+inline constexpr ColumnDescriptor<Item> TASK_COLUMNS[] = {
+    PST_CHILDREN(COLUMN_DESCRIPTOR) NOTE_CHILDREN(COLUMN_DESCRIPTOR)
+        TASK_CHILDREN(COLUMN_DESCRIPTOR)};
+
+template <typename Item>
+inline constexpr ColumnDescriptor<Item> DLIST_COLUMNS[] = {
+    PST_CHILDREN(COLUMN_DESCRIPTOR) NOTE_CHILDREN(COLUMN_DESCRIPTOR)
+        DLIST_CHILDREN(COLUMN_DESCRIPTOR)};
+
+template <typename Item>
+inline constexpr ColumnDescriptor<Item> FOLDER_COLUMNS[] = {
+    PST_CHILDREN(COLUMN_DESCRIPTOR) FOLDER_CHILDREN(COLUMN_DESCRIPTOR)};
+
+#undef COLUMN_DESCRIPTOR
+#undef BAG_PROP
+#undef STORE_PROP
+#undef NAMED_PROP
+#undef COMPUTED
+#undef COMPUTED_PROP
+#undef COMPUTED_NAMED_PROP
+
+/**
+ * @brief Get the descriptor table for the bag's message (or container) class
+ */
+template <typename Item> constexpr auto &class_columns() {
+  if constexpr (pst::is_folder_bag_v<Item>) {
+    return FOLDER_COLUMNS<Item>;
+  } else if constexpr (Item::klass == pst::MessageClass::Contact) {
+    return CONTACT_COLUMNS<Item>;
+  } else if constexpr (Item::klass == pst::MessageClass::Appointment) {
+    return APPOINTMENT_COLUMNS<Item>;
+  } else if constexpr (Item::klass == pst::MessageClass::StickyNote) {
+    return STICKY_NOTE_COLUMNS<Item>;
+  } else if constexpr (Item::klass == pst::MessageClass::Task) {
+    return TASK_COLUMNS<Item>;
+  } else if constexpr (Item::klass == pst::MessageClass::DistList) {
+    return DLIST_COLUMNS<Item>;
+  } else {
+    return NOTE_COLUMNS<Item>;
+  }
+}
+
+template <typename Item>
+ColumnPlan<Item> plan_columns(const vector<ColumnIndex> &column_indexes) {
+  constexpr auto &columns = class_columns<Item>();
+
+  ColumnPlan<Item> plan;
+  plan.readers.reserve(column_indexes.size());
+  idx_t bag_columns = 0;
+
+  for (idx_t col_idx = 0; col_idx < column_indexes.size(); ++col_idx) {
+    auto &column_index = column_indexes[col_idx];
+    auto schema_col = column_index.GetPrimaryIndex();
+
+    // Columns that don't exist on this class are always NULL
+    ColumnDescriptor<Item> descriptor = {PropSource::Computed, read_null<Item>,
+                                         0, nullptr, 0};
+
     switch (schema_col) {
-    case static_cast<int>(schema::PSTProjection::node_id):
     case schema::PST_VCOL_NODE_ID:
-      output.SetValue(col_idx, row_number, Value::UINTEGER(item.nid));
-      break;
-    case static_cast<int>(schema::PSTProjection::parent_node_id):
-      output.SetValue(
-          col_idx, row_number,
-          Value::UINTEGER(
-              item.sdk_object->get_property_bag().get_node().get_parent_id()));
+      descriptor.read = read_node_id<Item>;
       break;
     case schema::PST_VCOL_PARTITION_INDEX:
-      output.SetValue(col_idx, row_number,
-                      Value::UBIGINT(local_state.partition->partition_index));
+      descriptor.read = read_partition_index<Item>;
       break;
     default:
-      try {
-        // Bind PST attributes
-        set_output_column<pstsdk::pst>(local_state, output, *local_state.pst,
-                                       row_number, col_idx);
-
-        // If message-like, bind IPM.Note base attributes
-        if constexpr (!pst::is_folder_bag_v<Item>) {
-          set_output_column<pstsdk::message>(
-              local_state, output, *item.sdk_object, row_number, col_idx);
-        }
-
-        // If reading as note, we are already done
-        if constexpr (pst::is_base_msg_bag_v<Item>)
-          continue;
-
-        set_output_column(local_state, output, item, row_number, col_idx);
-      } catch (std::exception &e) {
-        auto schema_col = local_state.column_ids()[col_idx];
-        auto &output_schema = local_state.output_schema();
-
-        DUCKDB_LOG_ERROR(
-            local_state.ec, "Failed to read column: %s (%s)\nError: %s",
-            StructType::GetChildName(output_schema, schema_col),
-            StructType::GetChildType(output_schema, schema_col).ToString(),
-            e.what());
-
-        output.SetValue(col_idx, row_number, Value(nullptr));
-      }
+      if (schema_col < std::size(columns))
+        descriptor = columns[schema_col];
+      break;
+    }
+
+    ColumnReader<Item> reader = {descriptor, col_idx, schema_col, {}};
+
+    // Nested columns only read the STRUCT fields that the query uses
+    for (auto &child_index : column_index.GetChildIndexes())
+      reader.struct_fields.push_back(child_index.GetPrimaryIndex());
+
+    if (reader.source == PropSource::Bag || reader.source == PropSource::Named)
+      ++bag_columns;
+
+    plan.contents_table = plan.contents_table && in_contents_table(descriptor);
+
+    plan.readers.push_back(std::move(reader));
+  }
+
+  plan.list_props = bag_columns >= PROP_LIST_MIN_COLUMNS;
+  return plan;
+}
+
+template <typename Item>
+void into_row(PSTReadLocalState &local_state, const ColumnPlan<Item> &plan,
+              duckdb::DataChunk &output, Item &item, idx_t row_number) {
+  thread_local PropSet present;
+
+  // For wide projections, list the bag once instead of searching it for every
+  // column, then absent props are written as NULL without a lookup
+  if (plan.list_props)
+    present.assign(item.bag().get_prop_list());
+
+  for (auto &reader : plan.readers) {
+    auto &vec = output.data[reader.column_index];
+
+    if (plan.list_props &&
+        (reader.source == PropSource::Bag ||
+         reader.source == PropSource::Named) &&
+        !present.contains(reader.prop)) {
+      column_writer::write_null(vec, row_number);
+      continue;
+    }
+
+    try {
+      reader.read(local_state, reader, item, vec, row_number);
+    } catch (std::exception &e) {
+      auto &output_schema = local_state.output_schema();
+
+      DUCKDB_LOG_ERROR(
+          local_state.ec, "Failed to read column: %s (%s)\nError: %s",
+          StructType::GetChildName(output_schema, reader.schema_col),
+          StructType::GetChildType(output_schema, reader.schema_col)
+              .ToString(),
+          e.what());
+
+      column_writer::write_null(vec, row_number);
     }
   }
 }
 
+template ColumnPlan<pst::TypedBag<pst::MessageClass::Note, pstsdk::folder>>
+plan_columns<pst::TypedBag<pst::MessageClass::Note, pstsdk::folder>>(
+    const vector<ColumnIndex> &column_indexes);
+
 template void into_row<pst::TypedBag<pst::MessageClass::Note, pstsdk::folder>>(
-    PSTReadLocalState &local_state, duckdb::DataChunk &output,
+    PSTReadLocalState &local_state,
+    const ColumnPlan<pst::TypedBag<pst::MessageClass::Note, pstsdk::folder>>
+        &plan,
+    duckdb::DataChunk &output,
     pst::TypedBag<pst::MessageClass::Note, pstsdk::folder> &item,
     idx_t row_number);
 
+template ColumnPlan<pst::TypedBag<pst::MessageClass::Note>>
+plan_columns<pst::TypedBag<pst::MessageClass::Note>>(
+    const vector<ColumnIndex> &column_indexes);
+
 template void into_row<pst::TypedBag<pst::MessageClass::Note>>(
-    PSTReadLocalState &local_state, duckdb::DataChunk &output,
-    pst::TypedBag<pst::MessageClass::Note> &item, idx_t row_number);
+    PSTReadLocalState &local_state,
+    const ColumnPlan<pst::TypedBag<pst::MessageClass::Note>> &plan,
+    duckdb::DataChunk &output, pst::TypedBag<pst::MessageClass::Note> &item,
+    idx_t row_number);
+
+template ColumnPlan<pst::TypedBag<pst::MessageClass::Appointment>>
+plan_columns<pst::TypedBag<pst::MessageClass::Appointment>>(
+    const vector<ColumnIndex> &column_indexes);
 
 template void into_row<pst::TypedBag<pst::MessageClass::Appointment>>(
-    PSTReadLocalState &local_state, duckdb::DataChunk &output,
+    PSTReadLocalState &local_state,
+    const ColumnPlan<pst::TypedBag<pst::MessageClass::Appointment>> &plan,
+    duckdb::DataChunk &output,
     pst::TypedBag<pst::MessageClass::Appointment> &item, idx_t row_number);
 
+template ColumnPlan<pst::TypedBag<pst::MessageClass::Contact>>
+plan_columns<pst::TypedBag<pst::MessageClass::Contact>>(
+    const vector<ColumnIndex> &column_indexes);
+
 template void into_row<pst::TypedBag<pst::MessageClass::Contact>>(
-    PSTReadLocalState &local_state, duckdb::DataChunk &output,
-    pst::TypedBag<pst::MessageClass::Contact> &item, idx_t row_number);
+    PSTReadLocalState &local_state,
+    const ColumnPlan<pst::TypedBag<pst::MessageClass::Contact>> &plan,
+    duckdb::DataChunk &output, pst::TypedBag<pst::MessageClass::Contact> &item,
+    idx_t row_number);
+
+template ColumnPlan<pst::TypedBag<pst::MessageClass::StickyNote>>
+plan_columns<pst::TypedBag<pst::MessageClass::StickyNote>>(
+    const vector<ColumnIndex> &column_indexes);
 
 template void into_row<pst::TypedBag<pst::MessageClass::StickyNote>>(
-    PSTReadLocalState &local_state, duckdb::DataChunk &output,
+    PSTReadLocalState &local_state,
+    const ColumnPlan<pst::TypedBag<pst::MessageClass::StickyNote>> &plan,
+    duckdb::DataChunk &output,
     pst::TypedBag<pst::MessageClass::StickyNote> &item, idx_t row_number);
 
+template ColumnPlan<pst::TypedBag<pst::MessageClass::Task>>
+plan_columns<pst::TypedBag<pst::MessageClass::Task>>(
+    const vector<ColumnIndex> &column_indexes);
+
 template void into_row<pst::TypedBag<pst::MessageClass::Task>>(
-    PSTReadLocalState &local_state, duckdb::DataChunk &output,
-    pst::TypedBag<pst::MessageClass::Task> &item, idx_t row_number);
+    PSTReadLocalState &local_state,
+    const ColumnPlan<pst::TypedBag<pst::MessageClass::Task>> &plan,
+    duckdb::DataChunk &output, pst::TypedBag<pst::MessageClass::Task> &item,
+    idx_t row_number);
+
+template ColumnPlan<pst::TypedBag<pst::MessageClass::DistList>>
+plan_columns<pst::TypedBag<pst::MessageClass::DistList>>(
+    const vector<ColumnIndex> &column_indexes);
 
 template void into_row<pst::TypedBag<pst::MessageClass::DistList>>(
-    PSTReadLocalState &local_state, duckdb::DataChunk &output,
-    pst::TypedBag<pst::MessageClass::DistList> &item, idx_t row_number);
+    PSTReadLocalState &local_state,
+    const ColumnPlan<pst::TypedBag<pst::MessageClass::DistList>> &plan,
+    duckdb::DataChunk &output, pst::TypedBag<pst::MessageClass::DistList> &item,
+    idx_t row_number);
 
 } // namespace intellekt::duckpst::row_serializer
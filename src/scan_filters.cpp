@@ -0,0 +1,359 @@
+#include "scan_filters.hpp"
+#include "schema.hpp"
+
+#include "duckdb/common/enums/expression_type.hpp"
+#include "duckdb/common/types/interval.hpp"
+#include "duckdb/common/types/timestamp.hpp"
+#include "duckdb/planner/expression/bound_between_expression.hpp"
+#include "duckdb/planner/expression/bound_cast_expression.hpp"
+#include "duckdb/planner/expression/bound_columnref_expression.hpp"
+#include "duckdb/planner/expression/bound_comparison_expression.hpp"
+#include "duckdb/planner/expression/bound_constant_expression.hpp"
+#include "duckdb/planner/expression/bound_function_expression.hpp"
+#include "duckdb/planner/expression/bound_operator_expression.hpp"
+#include "pstsdk/mapitags.h"
+#include "pstsdk/util/util.h"
+
+#include <algorithm>
+#include <exception>
+#include <iterator>
+#include <limits>
+#include <utility>
+
+namespace intellekt::duckpst {
+using namespace duckdb;
+
+// Timestamp columns (all FILETIME props) whose range filters are checked
+// before the rest of a row is read
+static const std::pair<schema::NoteProjection, pstsdk::prop_id>
+    TIME_COLUMNS[] = {
+        {schema::NoteProjection::creation_time, PR_CREATION_TIME},
+        {schema::NoteProjection::last_modified, PR_LAST_MODIFICATION_TIME},
+        {schema::NoteProjection::message_delivery_time,
+         PR_MESSAGE_DELIVERY_TIME}};
+
+/**
+ * @brief Get the FILETIME prop of a timestamp column (0 if it isn't one)
+ */
+static pstsdk::prop_id time_column_prop(column_t column) {
+  for (auto &[time_column, prop] : TIME_COLUMNS) {
+    if (column == static_cast<column_t>(time_column))
+      return prop;
+  }
+  return 0;
+}
+
+/**
+ * @brief Narrow a filter to the values it shares with another predicate on
+ * the same column (filters are ANDed)
+ */
+template <typename T>
+static void restrict_to(std::optional<std::set<T>> &filter,
+                        std::set<T> &&values) {
+  if (!filter) {
+    filter = std::move(values);
+    return;
+  }
+
+  std::set<T> both;
+  std::set_intersection(filter->begin(), filter->end(), values.begin(),
+                        values.end(), std::inserter(both, both.begin()));
+  filter = std::move(both);
+}
+
+/**
+ * @brief Get the table function column an expression refers to
+ *
+ * @param timestamp_casts Also accept casts to a TIMESTAMP type without a time
+ * zone (which keep the order of TIMESTAMP_S values)
+ * @return false if it isn't a (plain) column of this scan
+ */
+static bool scan_column(const LogicalGet &get, const Expression &expr,
+                        column_t &column, bool timestamp_casts = false) {
+  auto *operand = &expr;
+  if (timestamp_casts &&
+      operand->GetExpressionClass() == ExpressionClass::BOUND_CAST) {
+    switch (operand->return_type.id()) {
+    case LogicalTypeId::TIMESTAMP:
+    case LogicalTypeId::TIMESTAMP_SEC:
+    case LogicalTypeId::TIMESTAMP_MS:
+    case LogicalTypeId::TIMESTAMP_NS:
+      operand = operand->Cast<BoundCastExpression>().child.get();
+      break;
+    default:
+      return false;
+    }
+  }
+
+  if (operand->GetExpressionClass() != ExpressionClass::BOUND_COLUMN_REF)
+    return false;
+
+  auto &column_ref = operand->Cast<BoundColumnRefExpression>();
+  auto &column_ids = get.GetColumnIds();
+  if (column_ref.binding.table_index != get.table_index ||
+      column_ref.binding.column_index >= column_ids.size())
+    return false;
+
+  column = column_ids[column_ref.binding.column_index].GetPrimaryIndex();
+  return true;
+}
+
+/**
+ * @brief Get the column and constants of `column = constant` or
+ * `column IN (constants...)`
+ *
+ * @return false if the filter has any other shape
+ */
+static bool column_values(const LogicalGet &get, const Expression &filter,
+                          column_t &column, vector<Value> &values) {
+  vector<const Expression *> operands;
+
+  if (filter.type == ExpressionType::COMPARE_EQUAL &&
+      filter.GetExpressionClass() == ExpressionClass::BOUND_COMPARISON) {
+    auto &comparison = filter.Cast<BoundComparisonExpression>();
+    operands = {comparison.left.get(), comparison.right.get()};
+
+    // Constants can be on either side of an equality
+    if (operands[0]->GetExpressionClass() == ExpressionClass::BOUND_CONSTANT)
+      std::swap(operands[0], operands[1]);
+  } else if (filter.type == ExpressionType::COMPARE_IN &&
+             filter.GetExpressionClass() == ExpressionClass::BOUND_OPERATOR) {
+    for (auto &child : filter.Cast<BoundOperatorExpression>().children)
+      operands.push_back(child.get());
+  } else {
+    return false;
+  }
+
+  if (operands.size() < 2 || !scan_column(get, *operands[0], column))
+    return false;
+
+  for (idx_t i = 1; i < operands.size(); ++i) {
+    if (operands[i]->GetExpressionClass() != ExpressionClass::BOUND_CONSTANT)
+      return false;
+
+    // NULL never compares equal, so it can't match anything
+    auto &value = operands[i]->Cast<BoundConstantExpression>().value;
+    if (!value.IsNull())
+      values.push_back(value);
+  }
+
+  return true;
+}
+
+/**
+ * @brief Get the prefix of `prefix(message_class, 'x')` (which is how DuckDB
+ * rewrites `LIKE 'x%'`) or `starts_with(message_class, 'x')`
+ */
+static bool class_prefix(const LogicalGet &get, const Expression &filter,
+                         std::string &prefix) {
+  if (filter.GetExpressionClass() != ExpressionClass::BOUND_FUNCTION)
+    return false;
+
+  auto &function = filter.Cast<BoundFunctionExpression>();
+  auto &name = function.function.name;
+  if ((name != "prefix" && name != "starts_with") ||
+      function.children.size() != 2 ||
+      function.children[1]->GetExpressionClass() !=
+          ExpressionClass::BOUND_CONSTANT)
+    return false;
+
+  column_t column;
+  auto &value = function.children[1]->Cast<BoundConstantExpression>().value;
+  if (value.IsNull() || !scan_column(get, *function.children[0], column) ||
+      column != static_cast<column_t>(schema::NoteProjection::message_class))
+    return false;
+
+  prefix = value.ToString();
+  return true;
+}
+
+/**
+ * @brief A timestamp constant in epoch microseconds
+ */
+static int64_t epoch_micros(const Value &value) {
+  auto timestamp = value.DefaultCastAs(LogicalType::TIMESTAMP);
+  return Timestamp::GetEpochMicroSeconds(timestamp.GetValue<timestamp_t>());
+}
+
+/**
+ * @brief Get the bounds of a range (or equality) predicate on a timestamp
+ * column. Bounds are inclusive, which only ever keeps extra rows.
+ */
+static bool time_range(const LogicalGet &get, const Expression &filter,
+                       pstsdk::prop_id &prop, int64_t &min, int64_t &max) {
+  column_t column;
+  auto is_time_column = [&](const Expression &expr) {
+    if (!scan_column(get, expr, column, true))
+      return false;
+    prop = time_column_prop(column);
+    return prop != 0;
+  };
+
+  auto is_constant = [](const Expression &expr) {
+    return expr.GetExpressionClass() == ExpressionClass::BOUND_CONSTANT &&
+           !expr.Cast<BoundConstantExpression>().value.IsNull();
+  };
+
+  if (filter.GetExpressionClass() == ExpressionClass::BOUND_BETWEEN) {
+    auto &between = filter.Cast<BoundBetweenExpression>();
+    if (!is_time_column(*between.input) || !is_constant(*between.lower) ||
+        !is_constant(*between.upper))
+      return false;
+
+    min = epoch_micros(between.lower->Cast<BoundConstantExpression>().value);
+    max = epoch_micros(between.upper->Cast<BoundConstantExpression>().value);
+    return true;
+  }
+
+  if (filter.GetExpressionClass() != ExpressionClass::BOUND_COMPARISON)
+    return false;
+
+  auto &comparison = filter.Cast<BoundComparisonExpression>();
+  auto type = comparison.type;
+  auto *column_side = comparison.left.get();
+  auto *constant_side = comparison.right.get();
+  if (is_constant(*column_side)) {
+    std::swap(column_side, constant_side);
+    type = FlipComparisonExpression(type);
+  }
+
+  if (!is_constant(*constant_side) || !is_time_column(*column_side))
+    return false;
+
+  auto bound =
+      epoch_micros(constant_side->Cast<BoundConstantExpression>().value);
+
+  switch (type) {
+  case ExpressionType::COMPARE_EQUAL:
+    min = max = bound;
+    return true;
+  case ExpressionType::COMPARE_GREATERTHAN:
+  case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+    min = bound;
+    return true;
+  case ExpressionType::COMPARE_LESSTHAN:
+  case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+    max = bound;
+    return true;
+  default:
+    return false;
+  }
+}
+
+void PSTScanFilters::collect(const LogicalGet &get, const Expression &filter,
+                             bool messages) {
+  try {
+    std::string prefix;
+    if (messages && class_prefix(get, filter, prefix)) {
+      message_class_prefixes.push_back(std::move(prefix));
+      return;
+    }
+
+    pstsdk::prop_id prop;
+    int64_t min = std::numeric_limits<int64_t>::min();
+    int64_t max = std::numeric_limits<int64_t>::max();
+    if (messages && time_range(get, filter, prop, min, max)) {
+      restrict_time(prop, min, max);
+      return;
+    }
+
+    column_t column;
+    vector<Value> values;
+    if (!column_values(get, filter, column, values))
+      return;
+
+    if (column == static_cast<column_t>(schema::PSTProjection::node_id) ||
+        column == schema::PST_VCOL_NODE_ID) {
+      std::set<pstsdk::node_id> nids;
+      for (auto &value : values)
+        nids.insert(value.GetValue<uint32_t>());
+      restrict_to(node_ids, std::move(nids));
+    } else if (column ==
+               static_cast<column_t>(schema::PSTProjection::parent_node_id)) {
+      std::set<pstsdk::node_id> nids;
+      for (auto &value : values)
+        nids.insert(value.GetValue<uint32_t>());
+      restrict_to(parent_node_ids, std::move(nids));
+    } else if (column ==
+               static_cast<column_t>(schema::PSTProjection::pst_path)) {
+      std::set<std::string> paths;
+      for (auto &value : values)
+        paths.insert(value.ToString());
+      restrict_to(pst_paths, std::move(paths));
+    } else if (messages &&
+               column == static_cast<column_t>(
+                             schema::NoteProjection::message_class)) {
+      std::set<std::string> classes;
+      for (auto &value : values)
+        classes.insert(value.ToString());
+      restrict_to(message_classes, std::move(classes));
+    }
+  } catch (std::exception &) {
+    // Constants that don't convert (e.g. out of range) are left to DuckDB
+  }
+}
+
+void PSTScanFilters::restrict_time(pstsdk::prop_id prop, int64_t min,
+                                   int64_t max) {
+  for (auto &range : time_ranges) {
+    if (range.prop == prop) {
+      range.min = std::max(range.min, min);
+      range.max = std::min(range.max, max);
+      return;
+    }
+  }
+
+  time_ranges.push_back({prop, min, max});
+}
+
+/**
+ * @brief Is a FILETIME within a range?
+ */
+static bool in_range(const PSTTimeRange &range, pstsdk::ulonglong filetime) {
+  auto micros = static_cast<int64_t>(pstsdk::filetime_to_time_t(filetime)) *
+                Interval::MICROS_PER_SEC;
+  return micros >= range.min && micros <= range.max;
+}
+
+bool PSTScanFilters::matches_times(pstsdk::const_property_object &bag) const {
+  for (auto &range : time_ranges) {
+    try {
+      // A NULL timestamp never satisfies a range
+      auto filetime = bag.read_prop_if_exists<pstsdk::ulonglong>(range.prop);
+      if (!filetime || !in_range(range, *filetime))
+        return false;
+    } catch (std::exception &) {
+      // Let the row through, the column will report the error
+    }
+  }
+
+  return true;
+}
+
+std::optional<bool>
+PSTScanFilters::row_matches_times(pstsdk::const_property_object &row) const {
+  std::optional<bool> matches = true;
+  for (auto &range : time_ranges) {
+    if (range.prop != PR_MESSAGE_DELIVERY_TIME &&
+        range.prop != PR_LAST_MODIFICATION_TIME) {
+      matches.reset();
+      continue;
+    }
+
+    try {
+      // A row without the cell (or a table without the column) leaves the
+      // range to the message's node
+      auto filetime = row.read_prop_if_exists<pstsdk::ulonglong>(range.prop);
+      if (!filetime)
+        matches.reset();
+      else if (!in_range(range, *filetime))
+        return false;
+    } catch (std::exception &) {
+      matches.reset();
+    }
+  }
+
+  return matches;
+}
+
+} // namespace intellekt::duckpst
@@ -9,6 +9,7 @@
 #include "duckdb/common/multi_file/multi_file_reader.hpp"
 #include "duckdb/common/named_parameter_map.hpp"
 #include "duckdb/common/open_file_info.hpp"
+#include "duckdb/common/string_util.hpp"
 #include "duckdb/common/table_column.hpp"
 #include "duckdb/common/types.hpp"
 #include "duckdb/function/function.hpp"
@@ -17,34 +18,67 @@
 #include "duckdb/logging/logger.hpp"
 #include "duckdb/main/client_context.hpp"
 #include "duckdb/main/client_data.hpp"
+#include "duckdb/parallel/task_scheduler.hpp"
 #include "duckdb/storage/statistics/node_statistics.hpp"
 
+#include "pst/block_cache.hpp"
 #include "pst/duckdb_filesystem.hpp"
+#include "pst/file_index.hpp"
 #include "pstsdk/pst/pst.h"
 #include "pstsdk/pst/folder.h"
 
+#include <algorithm>
+#include <atomic>
 #include <exception>
 #include <future>
 #include <limits>
+#include <optional>
+#include <tuple>
 
 namespace intellekt::duckpst {
 using namespace duckdb;
 
-PSTInputPartition::PSTInputPartition(const idx_t partition_index,
-                                     const shared_ptr<pstsdk::pst> pst,
-                                     const OpenFileInfo file,
-                                     const PSTReadFunctionMode mode,
-                                     PartitionStatistics stats,
-                                     const vector<node_id> &&nodes)
-    : partition_index(partition_index), pst(pst), file(file), mode(mode),
-      stats(std::move(stats)), nodes(nodes) {}
+PSTInputPartition::PSTInputPartition(
+    const idx_t partition_index, const shared_ptr<PSTMountedFile> mounted,
+    const OpenFileInfo file, const PSTReadFunctionMode mode,
+    PartitionStatistics stats, const vector<node_id> &&nodes)
+    : partition_index(partition_index), mounted(mounted), file(file),
+      mode(mode), stats(std::move(stats)), nodes(nodes) {}
 
 PSTInputPartition::PSTInputPartition(const PSTInputPartition &other_partition)
     : partition_index(other_partition.partition_index),
-      pst(other_partition.pst), file(other_partition.file),
+      mounted(other_partition.mounted), file(other_partition.file),
       mode(other_partition.mode), stats(other_partition.stats),
       nodes(other_partition.nodes){};
 
+PSTMountedFile::~PSTMountedFile() {
+  // Close the file before telling anyone it's closed
+  index.reset();
+  contents_rows.reset();
+  in_time_ranges.reset();
+  named_props.reset();
+  pst.reset();
+  blocks.reset();
+
+  if (on_release)
+    on_release();
+}
+
+shared_ptr<PSTMountedFile> PSTInputFile::mount(ClientContext &ctx) const {
+  auto mounted = make_shared_ptr<PSTMountedFile>();
+  mounted->blocks = pst::dfile::open(ctx, file);
+  mounted->pst = make_shared_ptr<pstsdk::pst>(mounted->blocks);
+  mounted->named_props = make_shared_ptr<pst::NamedPropCache>();
+
+  if (pst::FileIndex::enabled(ctx)) {
+    auto index = pst::FileIndex::load(ctx, file, *mounted->blocks);
+    if (index)
+      mounted->index = std::make_shared<pst::FileIndex>(std::move(*index));
+  }
+
+  return mounted;
+}
+
 PSTReadTableFunctionData::PSTReadTableFunctionData(
     ClientContext &ctx, const string &&path, const PSTReadFunctionMode mode,
     duckdb::named_parameter_map_t &named_parameters)
@@ -57,7 +91,11 @@ PSTReadTableFunctionData::PSTReadTableFunctionData(
     files.push_back(OpenFileInfo(path));
   }
 
-  plan_input_partitions(ctx);
+  // Reject bad parameters before mounting anything
+  scan_mode();
+
+  // Planning waits for the pushed down filters (see PSTReadCardinality)
+  validate_input_files(ctx);
 }
 
 template <typename T>
@@ -76,6 +114,10 @@ const idx_t PSTReadTableFunctionData::partition_size() const {
       parameter_or_default("partition_size", DEFAULT_PARTITION_SIZE), 1);
 }
 
+const idx_t PSTReadTableFunctionData::partition_bytes() const {
+  return parameter_or_default<idx_t>("partition_bytes", 0);
+}
+
 const idx_t PSTReadTableFunctionData::read_body_size_bytes() const {
   return parameter_or_default("read_body_size_bytes", DEFAULT_BODY_SIZE_BYTES);
 }
@@ -88,6 +130,17 @@ const idx_t PSTReadTableFunctionData::read_limit() const {
   return parameter_or_default("read_limit", std::numeric_limits<idx_t>().max());
 }
 
+const PSTScanMode PSTReadTableFunctionData::scan_mode() const {
+  auto name = parameter_or_default<string>("scan_mode", "auto");
+  auto maybe_mode = SCAN_MODES.find(StringUtil::Lower(name));
+  if (maybe_mode == SCAN_MODES.end())
+    throw InvalidInputException(
+        "Unknown scan_mode '%s' (expected auto, node or contents_table)",
+        name);
+
+  return maybe_mode->second;
+}
+
 void PSTReadTableFunctionData::bind_table_function_output_schema(
     vector<LogicalType> &return_types, vector<string> &names) {
   auto schema = output_schema(mode);
@@ -97,153 +150,506 @@ void PSTReadTableFunctionData::bind_table_function_output_schema(
   }
 }
 
+// Rows planned by the partitions so far (they are numbered in order)
+static idx_t planned_rows(const vector<PSTInputPartition> &partitions) {
+  if (partitions.empty())
+    return 0;
+  auto &tail = partitions.back();
+  return tail.stats.row_start + tail.stats.count;
+}
+
+/**
+ * @brief Appends partitions planned before the scan to the bind data
+ */
+class PSTBindPartitionSink : public PSTPartitionSink {
+  const PSTReadTableFunctionData &bind_data;
+  const idx_t limit;
+
+public:
+  PSTBindPartitionSink(const PSTReadTableFunctionData &bind_data)
+      : bind_data(bind_data), limit(bind_data.read_limit()) {}
+
+  idx_t remaining_rows() override {
+    auto total_rows = planned_rows(*bind_data.partitions.synchronize());
+    return limit - std::min(limit, total_rows);
+  }
+
+  void add_partition(const PSTInputFile &input,
+                     const shared_ptr<PSTMountedFile> &mounted,
+                     idx_t partition_index,
+                     vector<node_id> &&nodes) override {
+    auto sync_partitions = bind_data.partitions.synchronize();
+    auto total_rows = planned_rows(*sync_partitions);
+
+    nodes.resize(std::min<idx_t>(nodes.size(), limit - total_rows));
+    if (nodes.empty())
+      return;
+
+    PartitionStatistics stats;
+    stats.row_start = total_rows;
+    stats.count = nodes.size();
+    stats.count_type = CountType::COUNT_EXACT;
+
+    // The bind data lives as long as the query, so it doesn't keep the file
+    // open
+    sync_partitions->emplace_back<PSTInputPartition>(
+        {partition_index, nullptr, input.file, bind_data.mode, stats,
+         std::move(nodes)});
+  }
+};
+
+// Does a message of the given class belong in the read mode's output?
+static bool mode_includes(PSTReadFunctionMode mode, pst::MessageClass klass) {
+  switch (mode) {
+  case PSTReadFunctionMode::Appointment:
+    return klass == pst::MessageClass::Appointment;
+  case PSTReadFunctionMode::Contact:
+    return klass == pst::MessageClass::Contact;
+  case PSTReadFunctionMode::Note:
+    return klass == pst::MessageClass::Note;
+  case PSTReadFunctionMode::StickyNote:
+    return klass == pst::MessageClass::StickyNote;
+  case PSTReadFunctionMode::Task:
+    return klass == pst::MessageClass::Task;
+  case PSTReadFunctionMode::DistList:
+    return klass == pst::MessageClass::DistList;
+  default:
+    return true;
+  }
+}
+
+// Bytes of a data tree: the block itself, or the total an XBLOCK records
+static idx_t data_bytes(pstsdk::db_context &db, pstsdk::block_id bid) {
+  if (bid == 0)
+    return 0;
+  if (pstsdk::bid_is_internal(bid))
+    return db.read_data_block(bid)->get_total_size();
+  return db.lookup_block_info(bid).size;
+}
+
+/**
+ * @brief Approximate cost of reading a node: the size of its data, plus that
+ * of its subnodes (e.g. attachments and recipients). Only NBT/BBT entries and
+ * tree roots are read, never the data itself.
+ */
+static idx_t node_bytes(const pstsdk::pst &pst, node_id id) {
+  try {
+    auto db = pst.get_db();
+    auto node = db->lookup_node(id);
+
+    auto bytes = data_bytes(*db, node.get_data_id());
+    if (node.get_sub_id() == 0)
+      return bytes;
+
+    for (auto it = node.subnode_info_begin(); it != node.subnode_info_end();
+         ++it)
+      bytes += data_bytes(*db, it->data_bid);
+    return bytes;
+  } catch (std::exception &) {
+    // Reading the node will report it
+    return 0;
+  }
+}
+
+/**
+ * @brief Subfolders of some folders, read from their hierarchy tables rather
+ * than by crawling the NBT, in ascending NID order
+ *
+ * @return std::optional<vector<node_id>> Empty if a table can't be read
+ */
+static std::optional<vector<node_id>>
+child_folders(const pstsdk::pst &pst, const std::set<node_id> &parents) {
+  vector<node_id> children;
+  try {
+    auto db = pst.get_db();
+    for (auto parent : parents) {
+      if (get_nid_type(parent) != nid_type_folder)
+        continue;
+
+      pstsdk::node_info info;
+      try {
+        info = db->lookup_node_info(parent);
+      } catch (std::exception &) {
+        // Not in this file
+        continue;
+      }
+
+      // The root folder is its own parent
+      if (info.parent_id == parent)
+        children.push_back(parent);
+
+      auto hierarchy_id =
+          make_nid(nid_type_hierarchy_table, get_nid_index(parent));
+      pstsdk::table hierarchy(db->lookup_node(hierarchy_id));
+      for (pstsdk::ulong row = 0; row < hierarchy.size(); ++row)
+        children.push_back(hierarchy[row].get_row_id());
+    }
+  } catch (std::exception &) {
+    return {};
+  }
+
+  std::sort(children.begin(), children.end());
+  children.erase(std::unique(children.begin(), children.end()),
+                 children.end());
+  return children;
+}
+
 // TODO: this applies a filter when mode is not message
-void PSTReadTableFunctionData::plan_file_partitions(ClientContext &ctx,
-                                                    OpenFileInfo &file,
-                                                    idx_t limit) {
-  auto pst = make_shared_ptr<pstsdk::pst>(pst::dfile::open(ctx, file));
+bool PSTReadTableFunctionData::node_matches(const pstsdk::pst &pst,
+                                            node_id id) const {
+  auto nid_type = mode == PSTReadFunctionMode::Folder ? nid_type_folder
+                                                      : nid_type_message;
+  if (get_nid_type(id) != nid_type)
+    return false;
+
+  try {
+    auto info = pst.get_db()->lookup_node_info(id);
+    if (!filters.matches_parent(info.parent_id))
+      return false;
+
+    if (mode == PSTReadFunctionMode::Folder ||
+        (mode == PSTReadFunctionMode::Message && !filters.filters_classes()))
+      return true;
+
+    auto klass = pst::read_message_class(pst, id);
+    return filters.matches_class(klass) &&
+           mode_includes(mode, pst::message_class(klass.value_or("")));
+  } catch (std::exception &) {
+    // Not in this file
+    return false;
+  }
+}
+
+bool PSTReadTableFunctionData::message_matches(
+    const pst::MessageClassifier &classify, node_id id) const {
+  if (mode == PSTReadFunctionMode::Message && !filters.filters_classes())
+    return true;
+
+  auto klass = classify.name(id);
+  return filters.matches_class(klass) &&
+         mode_includes(mode, pst::message_class(klass.value_or("")));
+}
+
+void PSTReadTableFunctionData::plan_file_partitions(
+    ClientContext &ctx, const PSTInputFile &input,
+    const shared_ptr<PSTMountedFile> &mounted, PSTPartitionSink &sink) const {
+  // Scans of this file's first partitions may already be running, so
+  // planning uses its own copy of the pst
+  pstsdk::pst pst(*mounted->pst);
   vector<node_id> nodes;
 
-  idx_t total_rows = 0;
+  idx_t budget = sink.remaining_rows();
+  if (budget == 0)
+    return;
 
-  // Read the tail item if it exists as we start to spool the file
-  std::optional<PSTInputPartition> tail;
-  if (!this->partitions->empty())
-    tail.emplace(this->partitions->back());
+  // With partition_bytes, partitions are also closed by the bytes of their
+  // nodes, so heavy messages end up in partitions of their own
+  auto max_bytes = partition_bytes();
+  idx_t bytes = 0;
+
+  // Position of the next partition in the file
+  idx_t ordinal = 0;
+
+  // Scans of contents table rows read a partition's rows folder by folder,
+  // in table order (rows planning can't place come last, by NID)
+  std::shared_ptr<const pst::ContentsRows> rows;
+  auto hand_over = [&]() {
+    if (rows) {
+      auto position = [&](node_id id) {
+        auto row = rows->find(id);
+        if (row == rows->end())
+          return std::make_tuple(true, id, pstsdk::ulong(0));
+        return std::make_tuple(false, row->second.folder, row->second.row);
+      };
+      std::sort(nodes.begin(), nodes.end(), [&](node_id left, node_id right) {
+        return position(left) < position(right);
+      });
+    }
 
-  if (tail) {
-    total_rows = tail->stats.row_start + tail->stats.count;
+    sink.add_partition(input, mounted, input.partition_index(ordinal++),
+                       std::move(nodes));
+  };
+
+  auto flush = [&]() {
+    hand_over();
+    nodes.clear();
+    bytes = 0;
+
+    budget = sink.remaining_rows();
+    return budget > 0;
+  };
+
+  // Hand over the partition once it's full, returning false once the read
+  // limit is reached
+  auto add_node = [&](node_id id) {
+    if (max_bytes > 0) {
+      auto cost = node_bytes(pst, id);
+      if (!nodes.empty() && bytes + cost > max_bytes && !flush())
+        return false;
+      bytes += cost;
+    }
+
+    nodes.emplace_back(id);
+    if (nodes.size() < std::min(partition_size(), budget) &&
+        (max_bytes == 0 || bytes < max_bytes))
+      return true;
+
+    return flush();
+  };
+
+  // Messages whose contents table rows are outside a pushed down time range
+  // aren't planned, and those within every range aren't checked by the scan
+  pst::RowCheck check_times;
+  if (mode != PSTReadFunctionMode::Folder && !filters.time_ranges.empty()) {
+    check_times = [this](pstsdk::const_table_row &row) {
+      return filters.row_matches_times(row);
+    };
   }
 
-  if (mode == PSTReadFunctionMode::Folder) {
-    for (pstsdk::pst::folder_filter_iterator it = pst->folder_node_begin();
-         it != pst->folder_node_end(); ++it) {
-      if ((nodes.size() + total_rows) >= limit)
-        break;
-      nodes.emplace_back(it->id);
+  // Point lookups don't crawl the file at all
+  if (filters.node_ids) {
+    for (auto id : *filters.node_ids) {
+      if (node_matches(pst, id) && !add_node(id))
+        return;
     }
-  } else {
-    for (pstsdk::pst::message_filter_iterator it = pst->message_node_begin();
-         it != pst->message_node_end(); ++it) {
-      auto id = it->id;
 
-      if ((nodes.size() + total_rows) >= limit)
-        break;
+    if (!nodes.empty())
+      hand_over();
+    return;
+  }
 
-      if (mode == PSTReadFunctionMode::Message) {
-        nodes.emplace_back(id);
-        continue;
+  // Children of a few folders are enumerated from the folders' own tables
+  // (hierarchy tables for subfolders, contents tables for messages), and the
+  // NBT is only crawled if those can't be read
+  if (filters.parent_node_ids && mode == PSTReadFunctionMode::Folder) {
+    if (auto children = child_folders(pst, *filters.parent_node_ids)) {
+      for (auto id : *children) {
+        if (!add_node(id))
+          return;
       }
 
-      auto message_node = pst->get_db().get()->lookup_node(id);
+      if (!nodes.empty())
+        hand_over();
+      return;
+    }
+  } else if (filters.parent_node_ids) {
+    std::optional<pst::MessageClassifier> children;
+    try {
+      children.emplace(pst, *filters.parent_node_ids,
+                       sink.reads_contents_tables(), check_times);
+    } catch (std::exception &) {
+      // Crawled below
+    }
+
+    if (children) {
+      rows = children->contents_rows();
+      if (rows)
+        mounted->contents_rows = rows;
+      mounted->in_time_ranges = children->accepted_rows();
 
-      // It really sucks that the only way to determine a message class is by
-      // reading and asserting the string.
-      // TODO: Heuristic based on attribute presence (i.e. is chaining a few
-      // prop_exists calls faster than the string assert?)
-      auto klass = pst::message_class(*pst, id);
-      switch (mode) {
-      case PSTReadFunctionMode::Appointment:
-        if (klass != pst::MessageClass::Appointment)
-          continue;
-        break;
-      case PSTReadFunctionMode::Contact:
-        if (klass != pst::MessageClass::Contact)
-          continue;
-        break;
-      case PSTReadFunctionMode::Note:
-        if (klass != pst::MessageClass::Note)
-          continue;
-        break;
-      case PSTReadFunctionMode::StickyNote:
-        if (klass != pst::MessageClass::StickyNote)
+      for (auto id : children->messages()) {
+        if (!message_matches(*children, id))
           continue;
-        break;
-      case PSTReadFunctionMode::Task:
-        if (klass != pst::MessageClass::Task)
-          continue;
-        break;
-      case PSTReadFunctionMode::DistList:
-        if (klass != pst::MessageClass::DistList)
-          continue;
-        break;
-      default:
-        break;
+        if (!add_node(id))
+          return;
       }
 
-      nodes.emplace_back(id);
+      if (!nodes.empty())
+        hand_over();
+      return;
     }
   }
 
-  // Lock the partition queue and append partitions in order their NIDs are
-  // ready
-  auto sync_partitions = this->partitions.synchronize();
-  std::optional<PSTInputPartition> sync_tail;
-  if (!sync_partitions->empty())
-    sync_tail.emplace(sync_partitions->back());
-
-  // Reset the row count, as it may have changed
-  total_rows = 0;
-  if (sync_tail) {
-    total_rows = sync_tail->stats.row_start + sync_tail->stats.count;
+  // Build the index on the first scan (but not for limited reads, which
+  // would pay for crawling the whole file)
+  auto index = mounted->index;
+  if (!index && sink.builds_index() && pst::FileIndex::enabled(ctx) &&
+      read_limit() == std::numeric_limits<idx_t>::max()) {
+    auto built = std::make_shared<pst::FileIndex>(pst::FileIndex::build(pst));
+    built->save(ctx, input.file, *mounted->blocks);
+    index = std::move(built);
   }
 
-  while (!nodes.empty() && (total_rows < limit)) {
-    vector<node_id> partition_nodes;
-    PartitionStatistics stats;
-
-    stats.row_start = total_rows;
-    stats.count_type = CountType::COUNT_EXACT;
+  // The index doesn't record parents, or class names that aren't a
+  // MessageClass
+  if (filters.parent_node_ids || filters.filters_classes())
+    index.reset();
+
+  // Typed and class filtered reads classify messages from the contents
+  // tables (unless the index did), contents table scans need to know where
+  // the rows are, and time ranges are checked against the rows
+  std::optional<pst::MessageClassifier> classify;
+  if (mode != PSTReadFunctionMode::Folder &&
+      (sink.reads_contents_tables() || check_times ||
+       (!index &&
+        (mode != PSTReadFunctionMode::Message || filters.filters_classes()))))
+    classify.emplace(pst, sink.reads_contents_tables(), check_times);
+
+  if (classify && classify->contents_rows()) {
+    rows = classify->contents_rows();
+    mounted->contents_rows = rows;
+  }
+  if (classify)
+    mounted->in_time_ranges = classify->accepted_rows();
 
-    for (idx_t i = 0; i < this->partition_size(); ++i) {
-      if (i >= nodes.size() || ((i + total_rows) >= limit))
-        break;
-      partition_nodes.emplace_back(nodes.back());
-      nodes.pop_back();
+  if (index && mode == PSTReadFunctionMode::Folder) {
+    for (auto id : index->folders) {
+      if (!add_node(id))
+        return;
+    }
+  } else if (index) {
+    for (idx_t i = 0; i < index->messages.size(); ++i) {
+      auto klass = static_cast<pst::MessageClass>(index->message_classes[i]);
+      auto id = index->messages[i];
+      if (!mode_includes(mode, klass) || (classify && classify->rejects(id)))
+        continue;
+      if (!add_node(id))
+        return;
     }
+  } else if (mode == PSTReadFunctionMode::Folder) {
+    for (pstsdk::pst::folder_filter_iterator it = pst.folder_node_begin();
+         it != pst.folder_node_end(); ++it) {
+      if (filters.matches_parent(it->parent_id) && !add_node(it->id))
+        return;
+    }
+  } else {
+    // Untyped reads don't need message classes, unless they're filtered by
+    // class
+    auto classified =
+        mode != PSTReadFunctionMode::Message || filters.filters_classes();
 
-    stats.count = partition_nodes.size();
-    total_rows += partition_nodes.size();
+    for (pstsdk::pst::message_filter_iterator it = pst.message_node_begin();
+         it != pst.message_node_end(); ++it) {
+      auto id = it->id;
 
-    sync_partitions->emplace_back<PSTInputPartition>(
-        {sync_partitions->size(), pst, file, mode, stats,
-         std::move(partition_nodes)});
+      if (!filters.matches_parent(it->parent_id))
+        continue;
+
+      if (classified && !message_matches(*classify, id))
+        continue;
+
+      if (classify && classify->rejects(id))
+        continue;
+
+      if (!add_node(id))
+        return;
+    }
   }
+
+  if (!nodes.empty())
+    hand_over();
 }
 
-void PSTReadTableFunctionData::plan_input_partitions(ClientContext &ctx) {
-  if (!partitions->empty())
-    return;
-  auto total_rows = 0;
-  auto limit = this->read_limit();
+void PSTReadTableFunctionData::validate_input_files(ClientContext &ctx) {
+  vector<std::optional<PSTInputFile>> valid(files.size());
+  std::atomic<idx_t> next_file{0};
+
+  // Mounting reads (and validates) the header and the NBT/BBT roots. The
+  // files are only mounted again when they are planned, so no more than a
+  // few are ever open at once.
+  auto validate_files = [&]() {
+    for (idx_t i = next_file++; i < files.size(); i = next_file++) {
+      try {
+        auto blocks = pst::dfile::open(ctx, files[i]);
+        pstsdk::pst pst(blocks);
+        valid[i] = PSTInputFile{files[i], i, blocks->size()};
+      } catch (std::exception &e) {
+        DUCKDB_LOG_ERROR(ctx, "Unable to read PST file (%s): %s",
+                         files[i].path, e.what());
+      }
+    }
+  };
+
+  vector<std::future<void>> validate_tasks;
+  for (idx_t i = 0; i < planning_workers(ctx, files.size()); ++i)
+    validate_tasks.emplace_back(
+        std::async(std::launch::async, validate_files));
 
-  vector<std::future<void>> plan_tasks;
+  for (auto &task : validate_tasks)
+    task.get();
 
-  for (auto &file : files) {
-    plan_tasks.emplace_back(std::async(
-        std::launch::async, &PSTReadTableFunctionData::plan_file_partitions,
-        this, std::ref(ctx), std::ref(file), limit));
+  // Keep glob order
+  for (auto &input : valid) {
+    if (input)
+      inputs.emplace_back(std::move(*input));
   }
+}
+
+void PSTReadTableFunctionData::plan_bind_partitions(ClientContext &ctx,
+                                                    idx_t input_count) const {
+  std::lock_guard<std::mutex> guard(planning_lock);
+  PSTBindPartitionSink sink(*this);
 
-  for (idx_t i = 0; i < files.size(); ++i) {
+  input_count = std::min<idx_t>(input_count, inputs.size());
+  for (; planned_input_count < input_count; ++planned_input_count) {
+    auto &input = inputs[planned_input_count];
     try {
-      plan_tasks[i].get();
+      plan_file_partitions(ctx, input, input.mount(ctx), sink);
     } catch (std::exception &e) {
-      DUCKDB_LOG_ERROR(ctx, "Unable to read PST file (%s): %s", files[i].path,
-                       e.what());
+      DUCKDB_LOG_ERROR(ctx, "Unable to read PST file (%s): %s",
+                       input.file.path, e.what());
     }
   }
 
-  DUCKDB_LOG_INFO(ctx, "Planned %d partitions (%d files)", partitions->size(),
-                  files.size());
+  DUCKDB_LOG_INFO(ctx, "Planned %d partitions (%d of %d files)",
+                  partitions->size(), planned_input_count, inputs.size());
+}
+
+void PSTReadTableFunctionData::apply_filters(ClientContext &ctx,
+                                             PSTScanFilters &&scan_filters) {
+  std::lock_guard<std::mutex> guard(planning_lock);
+  filters = std::move(scan_filters);
+  if (!filters.narrows_planning())
+    return;
+
+  vector<PSTInputFile> matching_inputs;
+  for (auto &input : inputs) {
+    if (filters.matches_path(input.file.path))
+      matching_inputs.emplace_back(std::move(input));
+  }
+  inputs = std::move(matching_inputs);
+
+  // Nothing is normally planned before the filters are final, but anything
+  // that was is planned again (once) with them
+  partitions->clear();
+  planned_input_count = 0;
+}
+
+idx_t PSTReadTableFunctionData::planned_inputs() const {
+  std::lock_guard<std::mutex> guard(planning_lock);
+  return planned_input_count;
+}
+
+idx_t PSTReadTableFunctionData::estimated_rows() const {
+  std::lock_guard<std::mutex> guard(planning_lock);
+  auto rows = planned_rows(*partitions.synchronize());
+
+  // Point lookups read at most their NIDs from each file, other reads are
+  // estimated from the size of the files
+  auto unplanned_inputs = inputs.size() - planned_input_count;
+  if (filters.node_ids) {
+    rows += filters.node_ids->size() * unplanned_inputs;
+  } else {
+    auto row_bytes = mode == PSTReadFunctionMode::Folder
+                         ? ESTIMATED_FOLDER_BYTES
+                         : ESTIMATED_MESSAGE_BYTES;
+    for (idx_t i = planned_input_count; i < inputs.size(); ++i)
+      rows += std::max<idx_t>(inputs[i].size / row_bytes, 1);
+  }
+
+  return std::min(rows, read_limit());
 }
 
 PSTReadTableFunctionData::PSTReadTableFunctionData(
     const PSTReadTableFunctionData &other_data)
     : mode(other_data.mode) {
   files = other_data.files;
+  inputs = other_data.inputs;
   named_parameters = other_data.named_parameters;
+  filters = other_data.filters;
 
+  std::lock_guard<std::mutex> guard(other_data.planning_lock);
+  planned_input_count = other_data.planned_input_count;
   for (auto &part : *other_data.partitions.synchronize()) {
     this->partitions->emplace_back(PSTInputPartition(part));
   }
@@ -256,8 +662,8 @@ unique_ptr<FunctionData> PSTReadTableFunctionData::Copy() const {
 unique_ptr<GlobalTableFunctionState>
 PSTReadInitGlobal(ClientContext &ctx, TableFunctionInitInput &input) {
   auto &bind_data = input.bind_data->Cast<PSTReadTableFunctionData>();
-  auto global_state =
-      make_uniq<PSTReadGlobalState>(bind_data, input.column_ids);
+  auto global_state = make_uniq<PSTReadGlobalState>(
+      ctx, bind_data, input.column_ids, input.column_indexes, input.filters);
   return global_state;
 }
 
@@ -309,6 +715,11 @@ PSTReadInitLocal(ExecutionContext &ec, TableFunctionInitInput &input,
   return local_state;
 }
 
+idx_t planning_workers(ClientContext &ctx, idx_t tasks) {
+  auto threads = TaskScheduler::GetScheduler(ctx).NumberOfThreads();
+  return std::min<idx_t>(tasks, std::max<idx_t>(threads, 1));
+}
+
 unique_ptr<FunctionData> PSTReadBind(ClientContext &ctx,
                                      TableFunctionBindInput &input,
                                      vector<LogicalType> &return_types,
@@ -322,17 +733,29 @@ unique_ptr<FunctionData> PSTReadBind(ClientContext &ctx,
   return function_data;
 }
 
+void PSTPushdownComplexFilter(ClientContext &ctx, LogicalGet &get,
+                              FunctionData *bind_data,
+                              vector<unique_ptr<Expression>> &filters) {
+  auto &pst_data = bind_data->Cast<PSTReadTableFunctionData>();
+
+  // The filters stay in place (DuckDB still applies them), planning just
+  // skips what can't match
+  PSTScanFilters scan_filters;
+  auto messages = pst_data.mode != PSTReadFunctionMode::Folder;
+  for (auto &filter : filters)
+    scan_filters.collect(get, *filter, messages);
+
+  if (!scan_filters.empty())
+    pst_data.apply_filters(ctx, std::move(scan_filters));
+}
+
 unique_ptr<NodeStatistics> PSTReadCardinality(ClientContext &ctx,
                                               const FunctionData *data) {
-  auto pst_data = data->Cast<PSTReadTableFunctionData>();
-  idx_t max_cardinality = 0;
-
-  for (auto &partition : pst_data.partitions.get()) {
-    max_cardinality += partition.stats.count;
-  }
+  auto &pst_data = data->Cast<PSTReadTableFunctionData>();
 
-  auto stats = make_uniq<NodeStatistics>(max_cardinality, max_cardinality);
-  return stats;
+  // Planning crawls the files, which the optimizer (and EXPLAIN) shouldn't
+  // pay for, so this is estimated from their sizes. The scan plans them.
+  return make_uniq<NodeStatistics>(pst_data.estimated_rows());
 }
 
 vector<PartitionStatistics> PSTPartitionStats(ClientContext &ctx,
@@ -340,7 +763,11 @@ vector<PartitionStatistics> PSTPartitionStats(ClientContext &ctx,
   if (!input.bind_data)
     return vector<PartitionStatistics>();
 
-  auto pst_data = input.bind_data->Cast<PSTReadTableFunctionData>();
+  auto &pst_data = input.bind_data->Cast<PSTReadTableFunctionData>();
+
+  // Exact counts need every file planned, so this (only asked for when
+  // aggregates can be answered from statistics) plans them all up front
+  pst_data.plan_bind_partitions(ctx, pst_data.inputs.size());
 
   vector<PartitionStatistics> stats;
   for (auto &part : pst_data.partitions.get()) {
@@ -350,17 +777,58 @@ vector<PartitionStatistics> PSTPartitionStats(ClientContext &ctx,
   return stats;
 }
 
-// TODO
+// Does every row of a partition have the same value in this column?
+static bool single_value_column(column_t column) {
+  return column == static_cast<column_t>(schema::PSTProjection::pst_path) ||
+         column == schema::PST_VCOL_PARTITION_INDEX;
+}
+
 TablePartitionInfo PSTPartitionInfo(ClientContext &ctx,
                                     TableFunctionPartitionInput &input) {
-  return TablePartitionInfo::NOT_PARTITIONED;
+  // Partitions never span files (and stolen tails keep their partition index)
+  for (auto column : input.partition_ids) {
+    if (!single_value_column(column))
+      return TablePartitionInfo::NOT_PARTITIONED;
+  }
+
+  return input.partition_ids.empty()
+             ? TablePartitionInfo::NOT_PARTITIONED
+             : TablePartitionInfo::SINGLE_VALUE_PARTITIONS;
+}
+
+OperatorPartitionData
+PSTReadPartitionData(ClientContext &ctx,
+                     TableFunctionGetPartitionInput &input) {
+  auto &local_state = input.local_state->Cast<PSTReadLocalState>();
+  auto &scan = local_state.partition;
+  if (!scan)
+    return OperatorPartitionData(0);
+
+  // Chunks never span scans, so the chunk's rows all come from this one.
+  // Scans of unordered reads don't come in order, so they only get a batch
+  // index when one is asked for.
+  OperatorPartitionData data(
+      input.partition_info.batch_index
+          ? local_state.global_state.batch_index(*scan)
+          : 0);
+  for (auto column : input.partition_info.partition_columns) {
+    if (column == schema::PST_VCOL_PARTITION_INDEX)
+      data.partition_data.emplace_back(Value::UBIGINT(scan->partition_index));
+    else if (single_value_column(column))
+      data.partition_data.emplace_back(Value(scan->file.path));
+    else
+      throw InternalException("Column %d isn't a partition column of %s",
+                              column, scan->file.path);
+  }
+
+  return data;
 }
 
 double PSTReadProgress(ClientContext &context, const FunctionData *bind_data,
                        const GlobalTableFunctionState *global_state) {
   auto &pst_state = global_state->Cast<PSTReadGlobalState>();
   auto cardinality =
-      PSTReadCardinality(context, bind_data)->estimated_cardinality;
+      bind_data->Cast<PSTReadTableFunctionData>().estimated_rows();
   return (100.0 * pst_state.nodes_processed) / std::max<idx_t>(cardinality, 1);
 }
 
@@ -371,11 +839,26 @@ PSTDynamicToString(duckdb::TableFunctionDynamicToStringInput &input) {
   InsertionOrderPreservingMap<string> meta;
 
   meta.insert(make_pair("Files read", std::to_string(pst_data.files.size())));
-  meta.insert(make_pair("Partitions read",
-                        std::to_string(pst_data.partitions->size())));
+  // Partitions are planned while scanning, so only the global state knows
+  auto partitions_read = pst_data.partitions->size();
+  if (input.global_state)
+    partitions_read =
+        input.global_state->Cast<PSTReadGlobalState>().partitions_planned();
+
+  meta.insert(
+      make_pair("Partitions read", std::to_string(partitions_read)));
   meta.insert(
       make_pair("Partition size", std::to_string(pst_data.partition_size())));
 
+  // The cache is shared by all scans, so only this read's lookups count
+  if (input.global_state) {
+    auto &pst_state = input.global_state->Cast<PSTReadGlobalState>();
+    meta.insert(make_pair("Block cache hits",
+                          std::to_string(pst_state.cache_hits.load())));
+    meta.insert(make_pair("Block cache misses",
+                          std::to_string(pst_state.cache_misses.load())));
+  }
+
   return meta;
 }
 
@@ -405,8 +888,21 @@ vector<column_t> PSTRowIDColumns(ClientContext &ctx,
 void PSTReadFunction(ClientContext &ctx, TableFunctionInput &input,
                      DataChunk &output) {
   auto &local_state = input.local_state->Cast<PSTReadLocalState>();
-
-  idx_t rows = local_state.emit_rows(output);
-  output.SetCardinality(rows);
+  auto &global_state = input.global_state->Cast<PSTReadGlobalState>();
+  auto cache_usage = pst::BlockCache::thread_usage();
+
+  // An empty chunk ends the scan, so keep going until a row passes the
+  // pushed down filters (or there are no rows left)
+  do {
+    output.Reset();
+    idx_t rows = local_state.emit_rows(output);
+    output.SetCardinality(rows);
+    if (rows == 0)
+      break;
+
+    local_state.filter_rows(output);
+  } while (output.size() == 0);
+
+  global_state.count_cache_usage(cache_usage);
 }
 } // namespace intellekt::duckpst